@@ -0,0 +1,119 @@
+#ifndef BATCH_SOLVER_HPP
+#define BATCH_SOLVER_HPP
+
+#include "EngineSelector.hpp"
+#include "Portfolio.hpp"
+#include "Solver.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Headless solving of many puzzles (one 81-character string per puzzle).
+//
+// Unless disabled, every solution is audited by GridVerifier before it is
+// returned; one that breaks a unit or changes a given is reported unsolved.
+//
+// SCHEDULED estimates every puzzle first (Solver::estimateSearch) and solves
+// the cheap ones on the spot. Puzzles predicted above the portfolio threshold
+// are then raced by the portfolio one at a time, and the rest are spread over
+// worker threads longest-predicted-first so no thread is left with a hard
+// puzzle at the end.
+//
+// ADAPTIVE runs the logic pass on each puzzle, lets an EngineSelector pick
+// an engine (MRV, restarts, SAT or the portfolio) from what is left, and
+// finishes the puzzle with it.
+class BatchSolver {
+public:
+  enum class Engine { SCALAR, LOCKSTEP, PORTFOLIO, SCHEDULED, ADAPTIVE };
+
+  struct Result {
+    std::string solution; // Empty if the puzzle could not be solved
+    bool solved = false;
+    double estimatedNodes = 0.0; // Scheduled engine only
+  };
+
+  struct Stats {
+    long long solved = 0;
+    long long failed = 0;
+    long long recursions = 0; // Scalar, scheduled and adaptive engines
+    long long backtracks = 0; // Scalar, scheduled and adaptive engines
+    long long propagated = 0; // Lockstep engine: solved without branching
+    long long fallback = 0;   // Lockstep engine: finished by scalar Solver
+    std::vector<long long> portfolioWins; // Per portfolio config
+    long long routedToPortfolio = 0;      // Scheduled engine
+    double estimateSeconds = 0.0;         // Scheduled: estimation pass
+    long long verified = 0;               // Solutions that passed the audit
+    long long rejected = 0;               // Failed it; counted as failed
+    double verifySeconds = 0.0;
+    // Adaptive: puzzles per EngineSelector::Engine
+    std::vector<long long> enginePicks;
+    double seconds = 0.0;
+  };
+
+  explicit BatchSolver(Engine engine = Engine::SCALAR);
+
+  void setEngine(Engine engine);
+  Engine getEngine() const;
+
+  // Mode used by the scalar and scheduled engines (default HYBRID)
+  void setMode(Solver::Mode mode);
+
+  // Configurations raced per puzzle by the portfolio engine
+  void setPortfolio(const Portfolio &p);
+  const Portfolio &getPortfolio() const;
+
+  // Scheduled engine: worker threads (<= 0: hardware_concurrency()) and the
+  // predicted node count from which a puzzle is raced by the portfolio.
+  void setThreads(int threads);
+  void setPortfolioThreshold(double estimatedNodes);
+
+  // Cost table used by the adaptive engine (default: built-in table)
+  void setSelector(const EngineSelector &s);
+  const EngineSelector &getSelector() const;
+
+  // Audit solutions with GridVerifier (default on)
+  void setVerify(bool verify);
+
+  std::vector<Result> solveAll(const std::vector<std::string> &puzzles);
+  const Stats &getStats() const;
+
+  // Reads one puzzle per line; blank lines and lines starting with '#' are
+  // skipped. Returns false if the file cannot be opened.
+  static bool readPuzzleFile(const std::string &path,
+                             std::vector<std::string> &puzzles);
+  // Same for the lines that start in bytes [begin, end) (end < 0: to the
+  // end of the file); begin must be the start of a line.
+  static bool readPuzzleRange(const std::string &path, long long begin,
+                              long long end,
+                              std::vector<std::string> &puzzles);
+
+private:
+  Engine engine;
+  Solver::Mode mode = Solver::Mode::HYBRID;
+  Portfolio portfolio;
+  EngineSelector selector;
+  Stats stats;
+  int threadCount = 0;
+  double portfolioThreshold = 1e6; // About two seconds predicted
+  bool verifySolutions = true;
+
+  // Loads each puzzle and records its board as the solution if solveBoard
+  // returns true.
+  void solveEach(const std::vector<std::string> &puzzles,
+                 std::vector<Result> &results,
+                 const std::function<bool(SudokuBoard &)> &solveBoard);
+  void solveScalar(const std::vector<std::string> &puzzles,
+                   std::vector<Result> &results);
+  void solveLockstep(const std::vector<std::string> &puzzles,
+                     std::vector<Result> &results);
+  void solvePortfolio(const std::vector<std::string> &puzzles,
+                      std::vector<Result> &results);
+  void solveScheduled(const std::vector<std::string> &puzzles,
+                      std::vector<Result> &results);
+  void solveAdaptive(const std::vector<std::string> &puzzles,
+                     std::vector<Result> &results);
+  void verifyResults(const std::vector<std::string> &puzzles,
+                     std::vector<Result> &results);
+};
+
+#endif // BATCH_SOLVER_HPP
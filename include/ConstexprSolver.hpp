@@ -0,0 +1,105 @@
+#ifndef CONSTEXPR_SOLVER_HPP
+#define CONSTEXPR_SOLVER_HPP
+
+#include "SudokuBoard.hpp"
+#include "SudokuTables.hpp"
+#include <string_view>
+
+// MRV backtracking that also runs in constant expressions, for puzzles known
+// at build time (the sample grid, test fixtures): they are parsed, solved
+// and checked for uniqueness by the compiler and cost nothing at run time.
+//
+//   constexpr SudokuBoard kPuzzle = ConstexprSolver::parse("53..7....6..");
+//   static_assert(ConstexprSolver::countSolutions(kPuzzle, 2) == 1);
+//
+// The search is iterative with a fixed 81-frame stack (no recursion or heap,
+// which C++17 constant evaluation lacks) and has none of Solver's hooks.
+// Compilers cap the work of one constant expression (-fconstexpr-ops-limit,
+// -fconstexpr-steps), which an easy or typical puzzle stays well under; use
+// Solver at run time for hard ones.
+class ConstexprSolver {
+public:
+  // An empty board if text is malformed.
+  static constexpr SudokuBoard parse(std::string_view text) {
+    SudokuBoard board;
+    board.loadFromString(text);
+    return board;
+  }
+
+  // Solves board in place; false (board unchanged) if it has no solution.
+  static constexpr bool solve(SudokuBoard &board) {
+    return search(board, 1) == 1;
+  }
+
+  // The first solution, or puzzle itself if there is none.
+  static constexpr SudokuBoard solved(const SudokuBoard &puzzle) {
+    SudokuBoard board = puzzle;
+    solve(board);
+    return board;
+  }
+
+  // Solutions found, stopping at limit.
+  static constexpr long long countSolutions(const SudokuBoard &puzzle,
+                                            long long limit) {
+    SudokuBoard board = puzzle;
+    return search(board, limit);
+  }
+
+private:
+  struct Frame {
+    int cell = 0;
+    int mask = 0; // Candidates not tried yet
+  };
+
+  // Depth-first search. Stops on the limit-th solution with the board
+  // holding it; otherwise the board is restored when the tree runs out.
+  static constexpr long long search(SudokuBoard &board, long long limit) {
+    Frame stack[81] = {};
+    int depth = 0;
+    long long found = 0;
+    while (true) {
+      // MRV: the empty cell with the fewest candidates
+      int best = -1, bestMask = 0, bestCount = 10;
+      for (int cell = 0; cell < 81 && bestCount > 1; ++cell) {
+        int row = kSudokuTables.rowOf[cell], col = kSudokuTables.colOf[cell];
+        if (board.getValue(row, col) != 0)
+          continue;
+        int mask = board.getCandidates(row, col);
+        int count = 0;
+        for (int m = mask; m; m &= m - 1)
+          count++;
+        if (count < bestCount) {
+          best = cell;
+          bestMask = mask;
+          bestCount = count;
+        }
+      }
+      if (best < 0 && ++found >= limit)
+        return found;
+      if (best >= 0 && bestMask != 0)
+        stack[depth++] = Frame{best, bestMask};
+
+      // Next untried digit of the deepest frame that has one
+      while (true) {
+        if (depth == 0)
+          return found;
+        Frame &top = stack[depth - 1];
+        int row = kSudokuTables.rowOf[top.cell];
+        int col = kSudokuTables.colOf[top.cell];
+        board.removeNumber(row, col);
+        if (top.mask == 0) {
+          --depth;
+          continue;
+        }
+        int number = 1;
+        while (!(top.mask & (1 << number)))
+          number++;
+        top.mask &= top.mask - 1;
+        board.placeNumber(row, col, number);
+        break;
+      }
+    }
+  }
+};
+
+#endif // CONSTEXPR_SOLVER_HPP
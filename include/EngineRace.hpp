@@ -0,0 +1,86 @@
+#ifndef ENGINE_RACE_HPP
+#define ENGINE_RACE_HPP
+
+#include "Solver.hpp"
+#include "SudokuBoard.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Solves one puzzle with several Solver configurations side by side, each
+// on its own thread and its own board copy, at full speed (no step
+// callbacks). Unlike Portfolio, nobody is cancelled when the first lane
+// finishes: the point is to compare them.
+//
+// Live counters come from each lane's Solver::Heatmap, so they can be read
+// from another thread while the race runs. The SAT engine does not feed the
+// heatmap; its lane shows decisions and conflicts once it finishes.
+class EngineRace {
+public:
+  struct Lane {
+    std::string name;
+    Solver::Mode mode = Solver::Mode::HYBRID;
+    unsigned int seed = 1; // RANDOM_RESTARTS
+  };
+
+  struct Status {
+    bool finished = false;
+    bool solved = false;
+    int place = 0; // 1 = first to finish, 0 = still running
+    long long nodes = 0;
+    long long backtracks = 0;
+    double seconds = 0.0; // Until it finished, else until now
+    double nodesPerSecond = 0.0;
+  };
+
+  // Hybrid, pure MRV, randomized restarts and SAT.
+  EngineRace();
+  explicit EngineRace(const std::vector<Lane> &lanes);
+  ~EngineRace(); // Cancels and joins
+
+  EngineRace(const EngineRace &) = delete;
+  EngineRace &operator=(const EngineRace &) = delete;
+
+  static std::vector<Lane> defaultLanes();
+
+  // Cancels any race in progress, then starts every lane on a copy of
+  // puzzle.
+  void start(const SudokuBoard &puzzle);
+  void cancel();
+  void wait(); // Until every lane has finished
+
+  bool isRunning() const;
+  size_t size() const;
+  const Lane &getLane(size_t lane) const;
+  Status getStatus(size_t lane) const;
+
+  // The lane's working board. While the lane runs its solver writes it
+  // without locking, so a frame drawn from it may be a step behind.
+  const SudokuBoard &getBoard(size_t lane) const;
+
+private:
+  struct Runner {
+    Lane lane;
+    SudokuBoard board;
+    Solver::Heatmap heatmap;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+    std::atomic<bool> solved{false};
+    std::atomic<int> place{0};
+    std::atomic<long long> finalNodes{0};
+    std::atomic<long long> finalBacktracks{0};
+    std::atomic<long long> finishNs{0}; // Since the race started
+  };
+
+  std::vector<std::unique_ptr<Runner>> runners;
+  std::atomic<bool> cancelFlag{false};
+  std::atomic<int> finishedCount{0};
+  std::chrono::steady_clock::time_point startTime;
+
+  void join();
+};
+
+#endif // ENGINE_RACE_HPP
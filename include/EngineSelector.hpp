@@ -0,0 +1,112 @@
+#ifndef ENGINE_SELECTOR_HPP
+#define ENGINE_SELECTOR_HPP
+
+#include "Portfolio.hpp"
+#include "Solver.hpp"
+#include "SudokuBoard.hpp"
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Picks the engine expected to be cheapest for one puzzle.
+//
+// extract() runs the singles fixpoint (the logic pass HYBRID starts with)
+// and describes what is left: how many cells, how many candidates each, and
+// Solver::estimateSearch's size of the MRV tree and number of solutions
+// from there. Cells left, tree size and whether any probe reached a
+// solution map to one of kBuckets buckets, and the cost table holds the
+// mean measured solve time of every engine in every bucket. choose() takes
+// the cheapest engine with samples in the puzzle's bucket, MRV if there are
+// none. A puzzle the fixpoint finishes needs no search and gets LOGIC.
+//
+// The engines are genuinely different searches: MRV is deterministic
+// backtracking, RESTARTS the randomized search with Luby restarts, SAT the
+// CDCL encoding and PORTFOLIO races the default Portfolio on threads. In
+// the built-in table (calibrated on one core, see EngineSelector.cpp) MRV
+// wins most buckets; RESTARTS wins sparse puzzles with trees over 10^6
+// nodes where probes find solutions, since MRV's heavy tail dominates its
+// mean there; SAT wins large trees where no probe found a solution, which
+// are mostly unsolvable and which clause learning refutes in milliseconds
+// where MRV needs up to seconds. The portfolio's threads do not pay off on
+// one core. calibrate() and save()/load() let a deployment measure its own
+// machine and puzzle mix offline and ship the result.
+class EngineSelector {
+public:
+  enum class Engine { LOGIC, MRV, RESTARTS, SAT, PORTFOLIO };
+  static constexpr int kEngines = 5; // Indexed by static_cast<int>(Engine)
+  static constexpr int kBuckets = 30;
+
+  struct Features {
+    int clues = 0;
+    int logicPlacements = 0;  // Cells the singles fixpoint filled
+    int emptyAfterLogic = 0;  // Cells left for the search
+    int histogram[10] = {0};  // Empty cells by candidate count
+    double meanCandidates = 0.0;
+    bool contradiction = false; // An empty cell has no candidates left
+    double treeNodes = 0.0;     // Estimated MRV tree from the fixpoint
+    double solutions = 0.0;     // Estimated solutions (0: no probe found one)
+  };
+
+  struct Cost {
+    long long samples = 0;
+    double seconds = 0.0; // Total over the samples
+    double mean() const { return samples ? seconds / samples : 0.0; }
+  };
+
+  // Uses the built-in table.
+  EngineSelector();
+
+  // Runs the fixpoint on board in place. Solving that board afterwards
+  // gives the same result as solving the original; the logic pass is then
+  // already done.
+  static Features extract(SudokuBoard &board);
+  static int bucketOf(const Features &f);
+
+  Engine choose(const Features &f) const;
+  // Predicted seconds for engine on these features (0 if no samples)
+  double predict(const Features &f, Engine engine) const;
+
+  // Adds one measurement to the table.
+  void record(const Features &f, Engine engine, double seconds);
+
+  // Empties the table, then solves every puzzle (after extract) with each
+  // of engines, `repeats` times, and records the best time of each. LOGIC
+  // in engines is ignored. A run still going after limitSeconds is
+  // cancelled and recorded as taking limitSeconds (RESTARTS can need
+  // minutes to refute an unsolvable puzzle). Returns the number of puzzles
+  // measured.
+  int calibrate(const std::vector<std::string> &puzzles,
+                const std::vector<Engine> &engines, int repeats = 1,
+                double limitSeconds = 1.0);
+
+  struct Run {
+    bool solved = false;
+    long long recursions = 0; // MRV and RESTARTS
+    long long backtracks = 0;
+    int portfolioWinner = -1; // PORTFOLIO: index of the winning config
+  };
+
+  // Finishes board (after extract) with engine; board is left solved on
+  // success. RESTARTS uses a fixed seed so repeated runs agree. cancel
+  // stops the single-Solver engines (see Solver::setCancelFlag).
+  static Run solve(SudokuBoard &board, Engine engine, Portfolio &portfolio,
+                   const std::atomic<bool> *cancel = nullptr);
+
+  void clear();
+  const Cost &getCost(int bucket, Engine engine) const;
+
+  // Text format: "SDKCOSTS 2", then "<bucket> <engine> <samples> <seconds>"
+  // per non-empty entry. load replaces the table; false on a bad file.
+  bool save(const std::string &path) const;
+  bool load(const std::string &path);
+
+  static std::string engineName(Engine engine);
+  // The single-Solver mode closest to engine (PORTFOLIO: HYBRID), for
+  // callers that drive one Solver.
+  static Solver::Mode solverMode(Engine engine);
+
+private:
+  Cost table[kBuckets][kEngines];
+};
+
+#endif // ENGINE_SELECTOR_HPP
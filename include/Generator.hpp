@@ -1,28 +1,67 @@
 #ifndef GENERATOR_HPP
 #define GENERATOR_HPP
 
+#include "GridSampler.hpp"
 #include "Solver.hpp"
 #include "SudokuBoard.hpp"
+#include <bitset>
 #include <random>
+#include <string>
 
 
 class Generator {
 public:
-  enum class Difficulty { EASY, MEDIUM, HARD, EXPERT };
+  // MINIMAL removes clues until every remaining one is needed for a unique
+  // solution; the other levels remove a fixed number of random cells.
+  enum class Difficulty { EASY, MEDIUM, HARD, EXPERT, MINIMAL };
 
   Generator();
 
   // Generates a new puzzle on the provided board
   void generate(SudokuBoard &board, Difficulty level);
 
+  // Search nodes spent on uniqueness checks by the last MINIMAL generate.
+  long long getLastCheckNodes() const;
+
+  struct PatternOptions {
+    unsigned int seed = 0;        // 0 = random; repeatable with one thread
+    int threads = 0;              // <= 0 uses hardware_concurrency()
+    long long maxAttempts = 2000; // Starting grids tried across all threads
+  };
+
+  struct PatternResult {
+    bool found = false;
+    long long attempts = 0;
+    double seconds = 0.0;
+  };
+
+  // Parses a clue mask of 81 cells in row-major order: '.', '0' or '-' is an
+  // empty cell, any other character a given. Whitespace is skipped.
+  static bool parsePattern(const std::string &text, std::bitset<81> &mask);
+
+  // Generates a unique-solution puzzle whose givens sit exactly on mask.
+  // Each attempt starts from a random grid restricted to the mask and then
+  // changes single givens, keeping changes that do not increase the number
+  // of solutions, until one solution is left. The board is only changed on
+  // success. Masks with fewer than 17 cells fail immediately.
+  PatternResult generateWithPattern(SudokuBoard &board,
+                                    const std::bitset<81> &mask,
+                                    const PatternOptions &options);
+  PatternResult generateWithPattern(SudokuBoard &board,
+                                    const std::bitset<81> &mask);
+
+  // Clears the givens of a board with a single solution (e.g. a full grid)
+  // in an order drawn from rng, putting back each one whose removal would
+  // allow a second solution; the result is a minimal puzzle. Dead positions
+  // are memoized in table. Returns the search nodes spent on the checks.
+  static long long removeToMinimal(SudokuBoard &board, std::mt19937 &rng,
+                                   TranspositionTable &table);
+
 private:
-  void fillDiagonal(SudokuBoard &board);
-  void fillBox(SudokuBoard &board, int row, int col);
   void removeDigits(SudokuBoard &board, int count);
 
-  // Helper to check if a value is safe in a box (without full board overhead if
-  // needed, though board.isValid handles it)
-  bool unUsedInBox(SudokuBoard &board, int rowStart, int colStart, int num);
+  GridSampler sampler;
+  long long lastCheckNodes = 0;
 };
 
 #endif // GENERATOR_HPP
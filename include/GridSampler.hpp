@@ -0,0 +1,40 @@
+#ifndef GRID_SAMPLER_HPP
+#define GRID_SAMPLER_HPP
+
+#include "SudokuBoard.hpp"
+#include <cstdint>
+
+// Draws random complete 9x9 grids without searching. A table of base grids is
+// solved once per process; each sample picks one and applies a random
+// validity-preserving transformation: digit relabelling, band and stack
+// order, row order within bands, column order within stacks and an optional
+// transpose (9! * 6^8 * 2 variants per base grid). A sample is a few dozen
+// PRNG draws and 81 table lookups.
+//
+// Samples are confined to the equivalence classes of the base grids, which is
+// plenty for puzzle generation but not a uniform draw over all grids.
+class GridSampler {
+public:
+  // seed 0 draws a fresh seed from std::random_device; any other seed gives
+  // the same sequence of grids on every run.
+  explicit GridSampler(uint64_t seed = 0);
+
+  void reseed(uint64_t seed);
+
+  // Writes a complete grid, row-major, digits 1-9.
+  void sample(uint8_t grid[81]);
+
+  // Clears the board and places a complete grid (no givens).
+  void sample(SudokuBoard &board);
+
+  static constexpr int kBaseGrids = 64;
+
+private:
+  uint64_t state[4]; // xoshiro256**
+
+  uint64_t next();
+  int below(int n); // Uniform in [0, n)
+  void shuffle(uint8_t *items, int count);
+};
+
+#endif // GRID_SAMPLER_HPP
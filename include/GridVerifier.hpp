@@ -0,0 +1,74 @@
+#ifndef GRID_VERIFIER_HPP
+#define GRID_VERIFIER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Bulk audit of solved grids: every row, column and box must hold each digit
+// once, and every given of the matching puzzle must be kept.
+//
+// Like LockstepSolver, grids are transposed into kLanes lanes (cell-major,
+// lane-minor) of one-hot digit masks, so each unit check is an OR of nine
+// cells per lane followed by a compare against all nine digits, and each
+// givens check a compare per cell; the lane loops compile to SIMD code.
+class GridVerifier {
+public:
+  static constexpr int kLanes = 32;
+
+  enum class Verdict : uint8_t {
+    VALID,
+    MALFORMED,     // Not 81 characters '1'-'9'
+    BROKEN_UNIT,   // A row, column or box repeats a digit
+    GIVEN_CHANGED, // Differs from a given of its puzzle
+  };
+
+  struct Stats {
+    long long checked = 0;
+    long long valid = 0;
+    long long malformed = 0;
+    long long brokenUnit = 0;
+    long long givenChanged = 0;
+    double seconds = 0.0;
+  };
+
+  // Grid i of a batch, read in place.
+  using GridAt = std::function<std::string_view(size_t)>;
+
+  // verdicts[i] is the verdict for solutions[i]. With puzzles (same size,
+  // 81 characters, '0' or '.' empty) the givens are checked as well; an
+  // empty solution is MALFORMED.
+  std::vector<Verdict> verify(const std::vector<std::string> &solutions);
+  std::vector<Verdict> verify(const std::vector<std::string> &solutions,
+                              const std::vector<std::string> &puzzles);
+
+  // count back-to-back 81-byte records; puzzles may be null.
+  std::vector<Verdict> verify(const char *solutions, size_t count,
+                              const char *puzzles = nullptr);
+
+  // Views into the caller's own storage, so nothing is copied first. An
+  // empty puzzleAt skips the givens.
+  std::vector<Verdict> verify(size_t count, const GridAt &solutionAt,
+                              const GridAt &puzzleAt = nullptr);
+
+  const Stats &getStats() const;
+
+  // One grid at a time, for reference and spot checks. puzzle may be null,
+  // and like any puzzle that is not 81 characters it has no givens.
+  static Verdict verifyOne(const std::string &solution,
+                           const std::string *puzzle);
+
+private:
+  alignas(64) uint16_t digits[81][kLanes]; // One-hot, 0 = not a digit
+  alignas(64) uint16_t givens[81][kLanes]; // One-hot, 0 = empty in puzzle
+
+  Stats stats;
+
+  void verifyBlock(const GridAt &solutionAt, const GridAt &puzzleAt,
+                   size_t first, int count, std::vector<Verdict> &verdicts);
+};
+
+#endif // GRID_VERIFIER_HPP
@@ -0,0 +1,92 @@
+#ifndef HINT_ENGINE_HPP
+#define HINT_ENGINE_HPP
+
+#include "SolveTrace.hpp"
+#include "SudokuBoard.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Play-mode assistant. On load the position is solved (and checked for
+// uniqueness) on a background thread, so judging a move is a lookup against
+// the stored solution. Pencil marks are updated incrementally on each edit,
+// which keeps hints to a scan of 81 masks.
+//
+// Only a move that disagrees with the stored solution of a puzzle that is
+// not known to be unique needs more work: the position is then re-solved in
+// the background and getVerdict() reports CHECKING until it finishes. Once
+// the givens are known to have a single solution, a mismatch is WRONG
+// immediately.
+//
+// All methods are meant to be called from a single (UI) thread.
+class HintEngine {
+public:
+  enum class Verdict {
+    CHECKING,   // Background solve still running
+    SOLVABLE,   // Every placed digit is part of some solution
+    WRONG,      // Placed digits rule out every solution
+    NO_SOLUTION // The loaded puzzle itself cannot be solved
+  };
+
+  struct Hint {
+    bool found = false;
+    int row = -1;
+    int col = -1;
+    int value = 0;
+    TraceTechnique technique = TraceTechnique::NONE;
+    std::string text;
+  };
+
+  HintEngine() = default;
+  ~HintEngine();
+
+  HintEngine(const HintEngine &) = delete;
+  HintEngine &operator=(const HintEngine &) = delete;
+
+  // Takes the board as the new position and starts the background solve.
+  void load(const SudokuBoard &board);
+
+  // Mirror user edits; place() returns the verdict for the new position.
+  Verdict place(int row, int col, int value);
+  void clear(int row, int col);
+
+  Verdict getVerdict();
+
+  // Next step in order of difficulty: a wrong digit (unique puzzles only),
+  // naked single, hidden single, then the solution value of the cell with
+  // the fewest candidates.
+  Hint nextHint();
+
+  // Pencil marks (bits 1-9) of an empty cell.
+  uint16_t getCandidates(int row, int col) const;
+
+  // Blocks until the background solve has finished.
+  void wait();
+
+private:
+  SudokuBoard position;
+  SudokuBoard givens; // Fixed cells of the loaded board only
+  uint16_t candidates[81] = {0};
+
+  std::thread worker;
+  std::atomic<bool> cancel{false};
+  std::mutex mutex; // Guards the fields below
+  bool running = false;
+  bool haveSolution = false; // solution agrees with every placed digit
+  uint8_t solution[81] = {0};
+  bool countPending = false;
+  int givenSolutions = -1; // Solutions of the givens, capped at 2; -1 unknown
+
+  // Snapshots the position and solves it on the worker thread, followed by
+  // the uniqueness count of the givens if that is still pending.
+  void startJob();
+  void stopJob();
+  void refreshCell(int row, int col);
+  void refreshCandidates(int row, int col); // The cell and its 20 peers
+  bool hasMismatchLocked() const;
+  Verdict verdictLocked() const;
+};
+
+#endif // HINT_ENGINE_HPP
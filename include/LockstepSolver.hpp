@@ -0,0 +1,51 @@
+#ifndef LOCKSTEP_SOLVER_HPP
+#define LOCKSTEP_SOLVER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Batch engine that runs constraint propagation for many puzzles at once.
+//
+// Puzzles are packed into kLanes lanes of a structure-of-arrays board
+// (cell-major, lane-minor), so every step of candidate elimination, naked
+// singles and hidden singles is a plain loop over lanes that the compiler
+// turns into SIMD code. Lanes are retired as soon as their puzzle is solved,
+// proven contradictory, or stalls (needs branching); stalled puzzles are
+// finished by the scalar Solver and the lane is refilled from the queue.
+class LockstepSolver {
+public:
+  static constexpr int kLanes = 16;
+
+  struct Stats {
+    long long propagated = 0; // Solved by lockstep propagation alone
+    long long fallback = 0;   // Handed to the scalar backtracking Solver
+    long long failed = 0;     // Contradictory / unsolvable inputs
+    long long rounds = 0;     // Lockstep propagation rounds executed
+  };
+
+  LockstepSolver();
+
+  // Solves every puzzle (81-char strings, '0' or '.' empty).
+  // solutions[i] is the 81-char solution, or empty if puzzle i has none.
+  void solveBatch(const std::vector<std::string> &puzzles,
+                  std::vector<std::string> &solutions);
+
+  const Stats &getStats() const;
+
+private:
+  // bits 1-9 are used, matching SudokuBoard's masks.
+  alignas(64) uint16_t cand[81][kLanes];
+  alignas(64) uint16_t value[81][kLanes]; // One-hot digit, 0 if empty
+  int lanePuzzle[kLanes]; // -1 when the lane is idle (its cells are stale)
+
+  Stats stats;
+
+  void loadLane(int lane, const std::string &puzzle, int index);
+  void clearLanes();
+  void propagateRound(uint16_t changed[kLanes], uint16_t bad[kLanes]);
+  std::string extractLane(int lane) const;
+  std::string finishScalar(int lane) const;
+};
+
+#endif // LOCKSTEP_SOLVER_HPP
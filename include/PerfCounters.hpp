@@ -0,0 +1,63 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <string>
+
+// Hardware performance counters for the calling thread, via Linux
+// perf_event_open (user-space only, so perf_event_paranoid <= 2 suffices).
+//
+// Counters start when the object is constructed and run until it is
+// destroyed; measure a region by reading before and after it and taking
+// delta(). The hardware events are opened as one group so a read is a single
+// syscall and the ratios between them are consistent. Any event the kernel,
+// the PMU or a VM refuses is marked unavailable and reads as invalid; the
+// software task clock usually survives, and `seconds` is always wall time.
+// Elsewhere than Linux every event is unavailable.
+//
+// When the PMU multiplexes, counts are scaled by enabled/running time.
+class PerfCounters {
+public:
+  enum Event {
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_MISSES, // L1 data read misses
+    LLC_MISSES, // Last-level cache read misses
+    TASK_CLOCK, // Software: ns on CPU
+    kEventCount
+  };
+
+  struct Sample {
+    double values[kEventCount] = {0};
+    bool valid[kEventCount] = {false};
+    double seconds = 0.0; // Wall time
+  };
+
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  bool available(Event e) const;
+  bool hardwareAvailable() const; // At least one hardware event
+  // Why the first unavailable event failed to open ("" if none did)
+  const std::string &getError() const;
+
+  // Running totals since construction.
+  Sample read() const;
+  // to - from; an event is valid only if valid in both.
+  static Sample delta(const Sample &from, const Sample &to);
+
+  static const char *eventName(Event e);
+
+private:
+  int fds[kEventCount];
+  int groupLeader = -1; // fd of the hardware group, -1 if none opened
+  int groupIndex[kEventCount]; // Position in the group read, -1 if not in it
+  int groupSize = 0;
+  std::string error;
+  double startTime = 0.0;
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,46 @@
+#ifndef PORTFOLIO_HPP
+#define PORTFOLIO_HPP
+
+#include "Solver.hpp"
+#include "SudokuBoard.hpp"
+#include <string>
+#include <vector>
+
+// Races several Solver configurations on separate threads, each on its own
+// copy of the board. The first configuration to find a solution wins and the
+// others are cancelled.
+class Portfolio {
+public:
+  struct Config {
+    std::string name;
+    Solver::Mode mode = Solver::Mode::HYBRID;
+    unsigned int seed = 0; // Used by RANDOM_RESTARTS
+  };
+
+  struct Result {
+    bool solved = false;
+    int winnerIndex = -1; // Index into getConfigs(), -1 if nobody solved it
+    std::string winner;
+    long long winnerRecursions = 0;
+    double seconds = 0.0;
+  };
+
+  // Uses defaultConfigs(std::thread::hardware_concurrency()).
+  Portfolio();
+  explicit Portfolio(const std::vector<Config> &configs);
+
+  // HYBRID, BACKTRACK_ONLY and SAT, then randomized restarts with distinct
+  // seeds until `threads` configurations exist (at least four).
+  static std::vector<Config> defaultConfigs(int threads);
+
+  void setConfigs(const std::vector<Config> &configs);
+  const std::vector<Config> &getConfigs() const;
+
+  // Solves in place: on success the winning solution is copied into board.
+  Result solve(SudokuBoard &board);
+
+private:
+  std::vector<Config> configs;
+};
+
+#endif // PORTFOLIO_HPP
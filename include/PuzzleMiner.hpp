@@ -0,0 +1,108 @@
+#ifndef PUZZLE_MINER_HPP
+#define PUZZLE_MINER_HPP
+
+#include "SudokuBoard.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class TranspositionTable;
+
+// Evolves unique-solution puzzles that make the solver work as hard as
+// possible, to find adversarial inputs for latency testing.
+//
+// The elite archive holds the best distinct puzzles found so far. Each
+// generation breeds children from archive parents (better of two picked at
+// random) with one to three clue mutations: add a clue, remove one, or move
+// one to an empty cell. Every clue comes from the parent's solution, so a
+// child keeps that solution and only needs checking for a second one.
+// Children are checked and scored in parallel, one transposition table per
+// worker thread, and merged in a fixed order, so a seed gives the same
+// archive with any number of threads. The archive is rewritten after every
+// generation when a path is set.
+class PuzzleMiner {
+public:
+  enum class Objective {
+    BACKTRACKS, // Backtracks of the default HYBRID solve
+    NODES,      // Nodes of plain MRV search (BACKTRACK_ONLY)
+    RATING,     // Cells the singles rater cannot place, then HYBRID nodes
+  };
+
+  struct Options {
+    Objective objective = Objective::BACKTRACKS;
+    int threads = 0;        // <= 0: hardware_concurrency()
+    int archiveSize = 32;   // Elite puzzles kept
+    int children = 64;      // Per generation
+    int generations = 50;
+    double maxSeconds = 0.0; // Also stop after this long; 0 = no limit
+    uint64_t seed = 1;
+    int minClues = 17;
+    std::string archivePath; // Empty = keep in memory only
+  };
+
+  struct Elite {
+    std::string puzzle;   // 81 characters, '0' empty
+    std::string solution; // Its only solution
+    double fitness = 0.0; // Higher is harder under the objective
+    long long backtracks = 0;
+    long long nodes = 0;
+    int logicLeft = 0; // Empty cells after the singles fixpoint
+    int clues = 0;
+  };
+
+  struct Stats {
+    int generations = 0;
+    long long evaluated = 0; // Children checked
+    long long rejected = 0;  // A second solution, or no change
+    long long admitted = 0;  // Entered the archive
+    double seconds = 0.0;
+  };
+
+  // Called after every generation with the sorted archive.
+  using ProgressCallback =
+      std::function<void(int generation, const std::vector<Elite> &archive)>;
+
+  explicit PuzzleMiner(const Options &options);
+
+  void setProgressCallback(ProgressCallback callback);
+
+  // Adds a starting puzzle; false if it is malformed or not unique.
+  bool addSeed(const std::string &puzzle);
+  // Adds every puzzle of an archive file (scores are recomputed under the
+  // current objective). False if the file cannot be read.
+  bool load(const std::string &path);
+  // "SDKELITE 1", "objective <name>", then "<fitness> <backtracks> <nodes>
+  // <logic left> <puzzle>" per puzzle, hardest first.
+  bool save(const std::string &path) const;
+
+  // Seeds the archive with generated minimal puzzles if it is empty, then
+  // runs the generations. Returns the archive, hardest first.
+  const std::vector<Elite> &run();
+
+  const std::vector<Elite> &getArchive() const;
+  const Stats &getStats() const;
+
+  // Uniqueness check and scoring. table may be null.
+  static bool evaluate(const std::string &puzzle, Objective objective,
+                       TranspositionTable *table, Elite &out);
+
+  static std::string objectiveName(Objective objective);
+
+private:
+  Options options;
+  std::vector<Elite> archive;
+  Stats stats;
+  ProgressCallback progress;
+
+  int threadCount() const;
+  // Runs body(index, table) for index in [0, count) on the worker threads
+  void forEach(int count,
+               const std::function<void(int, TranspositionTable &)> &body);
+  bool admit(Elite elite);
+  std::string makeSeed(uint64_t index, TranspositionTable &table) const;
+  bool makeChild(const std::vector<Elite> &parents, int generation, int index,
+                 TranspositionTable &table, Elite &child) const;
+};
+
+#endif // PUZZLE_MINER_HPP
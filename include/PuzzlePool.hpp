@@ -0,0 +1,83 @@
+#ifndef PUZZLE_POOL_HPP
+#define PUZZLE_POOL_HPP
+
+#include "Generator.hpp"
+#include "SudokuBoard.hpp"
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Ready-made puzzles per difficulty, kept topped up by producer threads so a
+// "new puzzle" request is a queue pop instead of a generate() call.
+//
+// Each level refills with hysteresis: once it drops to the low watermark the
+// producers generate until it reaches the high watermark, then leave it
+// alone. With a persist path the pool is loaded on construction and saved
+// when it is destroyed, so a restart begins with full queues.
+class PuzzlePool {
+public:
+  struct Options {
+    size_t lowWatermark = 2;
+    size_t highWatermark = 8;
+    int producers = 1;
+    std::vector<Generator::Difficulty> levels; // Empty = every level
+    std::string persistPath;                   // Empty = no persistence
+  };
+
+  PuzzlePool();
+  explicit PuzzlePool(const Options &options);
+  ~PuzzlePool(); // Stops the producers and saves to the persist path
+
+  PuzzlePool(const PuzzlePool &) = delete;
+  PuzzlePool &operator=(const PuzzlePool &) = delete;
+
+  // Starts the producer threads; stop() joins them, waiting for puzzles
+  // already being generated.
+  void start();
+  void stop();
+
+  // Takes the oldest puzzle of that level (givens fixed). tryPop returns
+  // false at once if none is ready; pop waits for a producer and returns
+  // false only if the pool is not running or the level is not produced.
+  bool tryPop(Generator::Difficulty level, SudokuBoard &board);
+  bool pop(Generator::Difficulty level, SudokuBoard &board);
+
+  size_t size(Generator::Difficulty level) const;
+  long long getGenerated() const; // Puzzles made by the producers
+
+  // One "<level> <81 digits>" line per puzzle. load appends to the queues
+  // and skips lines it cannot parse; save replaces the file atomically.
+  bool save(const std::string &path) const;
+  bool load(const std::string &path);
+
+  static std::string levelName(Generator::Difficulty level);
+
+private:
+  static constexpr int kLevels = 5;
+
+  struct Level {
+    std::deque<std::string> puzzles;
+    bool enabled = false;
+    bool refilling = true;
+    int inFlight = 0; // Being generated right now
+  };
+
+  Options options;
+  std::array<Level, kLevels> levels;
+  mutable std::mutex mutex;
+  std::condition_variable wake;  // Producers: a level needs puzzles
+  std::condition_variable ready; // Consumers: a puzzle was added
+  std::vector<std::thread> producers;
+  bool stopping = false;
+  long long generated = 0;
+
+  void produce();
+  int pickLevelLocked() const; // -1 if nothing needs refilling
+  bool takeLocked(int level, SudokuBoard &board);
+};
+
+#endif // PUZZLE_POOL_HPP
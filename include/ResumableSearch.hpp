@@ -0,0 +1,76 @@
+#ifndef RESUMABLE_SEARCH_HPP
+#define RESUMABLE_SEARCH_HPP
+
+#include "Solver.hpp"
+#include "SudokuBoard.hpp"
+#include <atomic>
+#include <functional>
+#include <random>
+#include <string>
+
+// Solver's frame-stack MRV search (Solver::search), run in slices so its
+// whole state (path, untried digits per level, counters and RNG state) can
+// be written to a checkpoint file and resumed exactly in a later process.
+//
+// Checkpoint file (text, one item per line):
+//   SDKCHECKPOINT 2            version 1 randomized only the value order
+//   puzzle <81 chars>          givens, '0' = empty
+//   limit <n>                  solutions to stop at, 0 = all
+//   nodes <n> / solutions <n>
+//   expand <0|1> / finished <0|1> / random <0|1>
+//   rng <std::mt19937 state>
+//   frames <k>                 then k lines: <cell> <value> <untried mask>
+class ResumableSearch {
+public:
+  // Return false to stop the search (it stays resumable).
+  using SolutionCallback = std::function<bool(const SudokuBoard &)>;
+
+  ResumableSearch() = default;
+
+  // Starts a new search. solutionLimit 1 finds one solution, 2 proves
+  // uniqueness, 0 visits every solution. seed 0 tries digits in ascending
+  // order; any other seed randomizes MRV ties and the value order.
+  void start(const SudokuBoard &puzzle, long long solutionLimit,
+             unsigned int seed = 0);
+
+  // Writes a checkpoint every `everyNodes` nodes during run() (0 = never).
+  // The file is replaced atomically, so a kill mid-write keeps the old one.
+  void setCheckpointFile(const std::string &path, long long everyNodes);
+  void setSolutionCallback(SolutionCallback callback);
+  void setCancelFlag(const std::atomic<bool> *flag);
+
+  // Runs until the search finishes, the callback or cancel flag stops it,
+  // or maxNodes more nodes were visited (0 = no budget). A checkpoint is
+  // written whenever it stops unfinished. Returns isFinished().
+  bool run(long long maxNodes = 0);
+
+  bool saveCheckpoint(const std::string &path) const;
+  // Replaces the current state. Returns false if the file is missing,
+  // malformed or its path contradicts the puzzle.
+  bool loadCheckpoint(const std::string &path);
+
+  bool isFinished() const;
+  long long getNodes() const;
+  long long getSolutions() const;
+  int getDepth() const;
+
+  // Current position; after a FIRST solution (limit 1) it is the solution.
+  const SudokuBoard &getBoard() const;
+
+private:
+  SudokuBoard puzzle;
+  SudokuBoard board;
+  Solver::SearchState state;
+  long long solutionLimit = 0;
+  bool randomOrder = false;
+  std::mt19937 rng;
+
+  std::string checkpointPath;
+  long long checkpointEvery = 0;
+  SolutionCallback onSolution;
+  const std::atomic<bool> *cancelFlag = nullptr;
+
+  void checkpoint() const;
+};
+
+#endif // RESUMABLE_SEARCH_HPP
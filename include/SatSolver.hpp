@@ -0,0 +1,113 @@
+#ifndef SAT_SOLVER_HPP
+#define SAT_SOLVER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Self-contained CDCL SAT solver: two watched literals, first-UIP clause
+// learning with basic minimization, VSIDS decisions with phase saving, Luby
+// restarts and activity-based learned clause deletion.
+//
+// The external interface uses DIMACS-style literals: variable v (1-based) is
+// +v, its negation -v.
+class CdclSolver {
+public:
+  enum class Result { SATISFIABLE, UNSATISFIABLE, UNKNOWN };
+
+  CdclSolver();
+
+  // Creates a new variable and returns its 1-based index.
+  int newVar();
+  int numVars() const;
+
+  // Adds a clause at the top level. Returns false once the formula is known
+  // to be unsatisfiable.
+  bool addClause(const std::vector<int> &lits);
+
+  // UNKNOWN is only returned when the cancel flag was raised.
+  Result solve();
+
+  // Value of variable v (1-based) in the last satisfying assignment.
+  bool modelValue(int v) const;
+
+  void setCancelFlag(const std::atomic<bool> *flag);
+
+  long long getDecisions() const;
+  long long getConflicts() const;
+  long long getPropagations() const;
+  long long getLearnedClauses() const;
+
+private:
+  static constexpr int8_t kUndef = -1;
+
+  struct Clause {
+    std::vector<int> lits; // Internal literals: 2 * var + sign
+    bool learnt = false;
+    bool deleted = false;
+    double activity = 0.0;
+  };
+
+  struct Watcher {
+    int clause;
+    int blocker; // If this literal is true the clause is satisfied
+  };
+
+  bool ok = true;
+  std::vector<Clause> clauses;
+  std::vector<int> learnts;                 // Indices of learned clauses
+  std::vector<std::vector<Watcher>> watches; // Indexed by literal
+
+  std::vector<int8_t> assigns; // Per variable: kUndef, 0 (false), 1 (true)
+  std::vector<int> level;
+  std::vector<int> reason; // Clause index or -1
+  std::vector<int8_t> polarity;
+  std::vector<int8_t> seen;
+  std::vector<int> trail;
+  std::vector<int> trailLim;
+  size_t qhead = 0;
+  std::vector<int8_t> model;
+
+  // VSIDS
+  std::vector<double> activity;
+  double varInc = 1.0;
+  double clauseInc = 1.0;
+  std::vector<int> heap;    // Binary max-heap of variables by activity
+  std::vector<int> heapPos; // -1 when not in the heap
+
+  long long decisions = 0;
+  long long conflicts = 0;
+  long long propagations = 0;
+  double maxLearnts = 0.0;
+  const std::atomic<bool> *cancelFlag = nullptr;
+
+  int8_t litValue(int lit) const {
+    int8_t v = assigns[lit >> 1];
+    return v == kUndef ? kUndef : static_cast<int8_t>(v ^ (lit & 1));
+  }
+  int decisionLevel() const { return static_cast<int>(trailLim.size()); }
+  static int toInternal(int dimacs) {
+    return dimacs > 0 ? 2 * (dimacs - 1) : 2 * (-dimacs - 1) + 1;
+  }
+
+  void enqueue(int lit, int from);
+  int propagate(); // Conflict clause index, or -1
+  void analyze(int confl, std::vector<int> &learnt, int &backtrackLevel);
+  void cancelUntil(int lvl);
+  int attachClause(const std::vector<int> &lits, bool learnt);
+  int pickBranchLit();
+  void reduceLearnts();
+  bool isLocked(int clauseIndex) const;
+
+  void bumpVar(int v);
+  void bumpClause(Clause &c);
+  void heapInsert(int v);
+  int heapPop();
+  void heapUp(int i);
+  void heapDown(int i);
+
+  static long long luby(int i);
+};
+
+#endif // SAT_SOLVER_HPP
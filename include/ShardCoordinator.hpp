@@ -0,0 +1,71 @@
+#ifndef SHARD_COORDINATOR_HPP
+#define SHARD_COORDINATOR_HPP
+
+#include "BatchSolver.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Solves a puzzle file with several worker processes instead of threads.
+//
+// The file is cut into byte-range shards on line boundaries. Each worker is
+// a forked copy of this process that runs the configured BatchSolver on
+// its shard and streams one result line per puzzle back through a pipe,
+// ending with its stats and a "#done <count>" line. Workers are pinned to
+// disjoint sets of the CPUs this process may use (Linux). A worker that
+// crashes, is killed or exits without the #done line has its shard queued
+// again, up to maxAttempts times; after that the shard's puzzles are
+// reported unsolved. Results are merged in input order.
+//
+// Needs POSIX fork/pipe; elsewhere solve() falls back to one in-process
+// BatchSolver run.
+class ShardCoordinator {
+public:
+  struct Options {
+    int workers = 0;     // <= 0: one per CPU
+    int shards = 0;      // <= 0: four per worker
+    int maxAttempts = 3; // Per shard
+    bool pin = true;     // Pin workers to disjoint CPU sets (Linux only)
+  };
+
+  struct Stats {
+    // Summed over shards, portfolio wins and engine picks per entry (phase
+    // times are CPU-seconds across workers); seconds is wall time.
+    BatchSolver::Stats batch;
+    int shards = 0;
+    int requeued = 0;     // Worker runs that died and were retried
+    int failedShards = 0; // Gave up after maxAttempts
+    int workers = 0;
+  };
+
+  // Called in the worker process before it solves (shard index, attempt
+  // number from 0). Lets tests make a worker fail on purpose.
+  using WorkerHook = std::function<void(int shard, int attempt)>;
+
+  ShardCoordinator(const BatchSolver &batch, const Options &options);
+
+  void setWorkerHook(WorkerHook hook);
+
+  // Returns false if the file cannot be read or a pipe, fork or poll call
+  // fails; running workers are then killed and reaped first. getError()
+  // says which.
+  bool solve(const std::string &path,
+             std::vector<BatchSolver::Result> &results);
+
+  const Stats &getStats() const;
+  // Why the last solve() returned false ("" if it did not)
+  const std::string &getError() const;
+
+  // [begin, end) byte ranges starting on line boundaries, roughly equal.
+  static std::vector<std::pair<long long, long long>>
+  splitFile(const std::string &path, int shards);
+
+private:
+  BatchSolver batch;
+  Options options;
+  WorkerHook workerHook;
+  Stats stats;
+  std::string error;
+};
+
+#endif // SHARD_COORDINATOR_HPP
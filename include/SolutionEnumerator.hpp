@@ -0,0 +1,55 @@
+#ifndef SOLUTION_ENUMERATOR_HPP
+#define SOLUTION_ENUMERATOR_HPP
+
+#include "SudokuBoard.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+
+// Enumerates every solution of a (possibly underconstrained) puzzle without
+// storing them. The search tree is split into a frontier of subproblems that
+// worker threads pull from; solutions pass through a bounded queue, so slow
+// sinks apply backpressure instead of letting memory grow.
+//
+// Solutions arrive in no particular order. The sink always runs on the
+// calling thread and need not be thread-safe.
+class SolutionEnumerator {
+public:
+  // Return false to stop the enumeration early.
+  using Sink = std::function<bool(const SudokuBoard &)>;
+
+  struct Result {
+    long long solutions = 0;
+    bool complete = false; // False if stopped by the sink or cancel flag
+    double seconds = 0.0;
+  };
+
+  // threads <= 0 uses std::thread::hardware_concurrency().
+  explicit SolutionEnumerator(int threads = 0);
+
+  // Maximum number of solutions queued for the sink. Each worker also holds
+  // up to 64 solutions of its own while it waits for room.
+  void setQueueCapacity(size_t capacity);
+  void setCancelFlag(const std::atomic<bool> *flag);
+
+  Result enumerate(const SudokuBoard &board, const Sink &sink);
+
+  // Writes one 81-character solution per line.
+  Result enumerate(const SudokuBoard &board, std::ostream &out);
+
+  // Count-only path: workers only add up subtree counts, so no solution is
+  // copied, queued or handed to a sink.
+  Result count(const SudokuBoard &board);
+
+private:
+  int threadCount;
+  size_t queueCapacity = 4096;
+  const std::atomic<bool> *cancelFlag = nullptr;
+
+  bool isCancelled() const {
+    return cancelFlag && cancelFlag->load(std::memory_order_relaxed);
+  }
+};
+
+#endif // SOLUTION_ENUMERATOR_HPP
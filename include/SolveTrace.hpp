@@ -0,0 +1,110 @@
+#ifndef SOLVE_TRACE_HPP
+#define SOLVE_TRACE_HPP
+
+#include "SudokuBoard.hpp"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary solve trace.
+//
+// File layout:
+//   "SDKT" magic, 1 byte version, 81 bytes initial board (row-major, 0 =
+//   empty), followed by a stream of records.
+//
+// Each record is delta-encoded against the previous one:
+//   byte 0 : event type (bits 0-1) | technique (bits 2-4)
+//   byte 1 : cell index (row * 9 + col)
+//   byte 2 : value (0 for removals)
+//   varint : zig-zag encoded depth delta
+//   varint : nanoseconds since previous record
+// A typical record is 5-7 bytes, so multi-million node searches stay small.
+
+enum class TraceEvent : uint8_t { PLACE = 0, REMOVE = 1, LOGIC = 2 };
+
+enum class TraceTechnique : uint8_t {
+  NONE = 0,
+  GUESS = 1,
+  NAKED_SINGLE = 2,
+  HIDDEN_SINGLE_ROW = 3,
+  HIDDEN_SINGLE_COL = 4,
+  HIDDEN_SINGLE_BOX = 5,
+  SAT = 6
+};
+
+struct TraceRecord {
+  TraceEvent event = TraceEvent::PLACE;
+  TraceTechnique technique = TraceTechnique::NONE;
+  int cell = 0;
+  int value = 0;
+  int depth = 0;
+  uint64_t deltaNs = 0; // Time since the previous record
+};
+
+std::string techniqueToString(TraceTechnique t);
+
+class TraceWriter {
+public:
+  TraceWriter() = default;
+  ~TraceWriter();
+
+  TraceWriter(const TraceWriter &) = delete;
+  TraceWriter &operator=(const TraceWriter &) = delete;
+
+  // Opens the file and writes the header with the starting board.
+  // Returns false if the file cannot be created.
+  bool open(const std::string &path, const SudokuBoard &initial);
+  // Flushes and closes the file. Returns false if any write since open()
+  // failed (disk full, I/O error); the trace is then incomplete.
+  bool close();
+  bool isOpen() const;
+
+  void record(TraceEvent event, TraceTechnique technique, int row, int col,
+              int value, int depth);
+
+  uint64_t getRecordCount() const;
+
+private:
+  static constexpr size_t kBufferSize = 1 << 16;
+
+  std::ofstream out;
+  std::vector<uint8_t> buffer;
+  std::chrono::steady_clock::time_point lastTime;
+  int lastDepth = 0;
+  uint64_t recordCount = 0;
+  bool failed = false;
+
+  void flush();
+  void putVarint(uint64_t v);
+};
+
+class TraceReader {
+public:
+  // Opens the trace and reads its header. Returns false on I/O error or if
+  // the file is not a trace.
+  bool open(const std::string &path);
+
+  // Reads the next record. Returns false at end of stream or on a truncated
+  // record.
+  bool next(TraceRecord &rec);
+
+  // Board stored in the header (row-major, 0 = empty).
+  const uint8_t *getInitialGrid() const;
+
+private:
+  static constexpr size_t kBufferSize = 1 << 16;
+
+  std::ifstream in;
+  std::vector<uint8_t> buffer;
+  size_t pos = 0;
+  size_t len = 0;
+  int lastDepth = 0;
+  uint8_t initialGrid[81] = {0};
+
+  bool getByte(uint8_t &b);
+  bool getVarint(uint64_t &v);
+};
+
+#endif // SOLVE_TRACE_HPP
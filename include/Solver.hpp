@@ -2,22 +2,44 @@
 #define SOLVER_HPP
 
 #include "SudokuBoard.hpp"
+#include <array>
+#include <atomic>
+#include <climits>
 #include <functional>
 #include <random>
 #include <utility>
 
+class TraceWriter;
+class TranspositionTable;
 
 class Solver {
 public:
   // Constructor takes a reference to the board to solve
   explicit Solver(SudokuBoard &board);
 
-  enum class Mode { LOGIC_ONLY, BACKTRACK_ONLY, HYBRID };
+  // SAT: CNF encoding solved by the built-in CDCL engine (see SatSolver.hpp).
+  // Its recursion/backtrack counters report decisions/conflicts.
+  enum class Mode { LOGIC_ONLY, BACKTRACK_ONLY, HYBRID, RANDOM_RESTARTS, SAT };
+  enum class RestartSchedule { LUBY, GEOMETRIC };
   enum class Difficulty { UNKNOWN, EASY, MEDIUM, HARD, EXPERT };
 
   void setMode(Mode mode);
   Mode getMode() const;
 
+  // RANDOM_RESTARTS: randomized MRV tie-breaking and value order, restarted
+  // whenever a run exceeds its node budget. Budgets follow the Luby sequence
+  // (baseNodes * 1,1,2,1,1,2,4,...) or grow geometrically by growthFactor.
+  void setRestartSchedule(RestartSchedule schedule, long long baseNodes = 100,
+                          double growthFactor = 1.5);
+  // Node budget of restart `restart` (0-based) under the current schedule.
+  long long restartBudget(int restart) const;
+
+  // Seed for restart i is seed + i; solveRandomized() uses the seed itself.
+  // 0 draws a fresh seed per solve.
+  void setSeed(unsigned int seed);
+  unsigned int getWinningSeed() const; // Seed of the run that solved it
+  int getRestartCount() const;
+
   // Solves the board using backtracking or logic based on Mode
   // Returns true if a solution is found
   bool solve();
@@ -32,6 +54,118 @@ public:
   void
   setStepCallback(std::function<void(int, int, int, std::string)> callback);
 
+  // Stream every placement, removal and technique to a binary trace.
+  // The writer is not owned; pass nullptr to stop tracing.
+  void setTraceWriter(TraceWriter *writer);
+
+  // Cooperative cancellation: when *flag becomes true the search unwinds and
+  // solve() returns false. The flag is not owned; pass nullptr to clear.
+  void setCancelFlag(const std::atomic<bool> *flag);
+
+  // Memoizes dead positions (and subtree solution counts) by board hash so
+  // search and counting skip states reached through different move orders.
+  // The table is not owned and may be shared across solves on one thread.
+  void setTranspositionTable(TranspositionTable *table);
+
+  // Per-cell search counters for the heatmap overlay. The search thread
+  // updates them with relaxed atomics (single writer, no read-modify-write),
+  // so another thread can read them while a solve is running.
+  struct Heatmap {
+    std::atomic<uint32_t> branches[81];   // MRV chose the cell to branch on
+    std::atomic<uint32_t> backtracks[81]; // A guessed digit was taken back
+    std::atomic<uint32_t> changes[81];    // A guessed digit was placed
+    std::atomic<long long> nodes;
+    std::atomic<int> depth;
+
+    Heatmap();
+    void reset();
+  };
+
+  // Feeds the counters from the backtracking searches (not the logic pass or
+  // SAT). The heatmap is not owned; pass nullptr to stop.
+  void setHeatmap(Heatmap *heatmap);
+
+  // Counts solutions of the current position, stopping once `limit` have
+  // been found. The board is left unchanged.
+  long long countSolutions(long long limit = LLONG_MAX);
+
+  // Calls visit with the board filled in for every solution of the current
+  // position, until visit returns false or the search is cancelled. Returns
+  // the number of solutions visited; the board is left unchanged.
+  long long
+  enumerateSolutions(const std::function<bool(const SudokuBoard &)> &visit);
+
+  // The frame-stack MRV search behind solve(), countSolutions(),
+  // enumerateSolutions() and ResumableSearch. One frame per guessed cell;
+  // the frames and the board are the whole search, so a copy of the state
+  // is a snapshot: it can be written out, restored later, or split by
+  // handing some of a frame's untried digits to another solver.
+  struct SearchFrame {
+    uint64_t key = 0;          // Board hash on entry (transposition table)
+    long long foundBefore = 0; // Solutions found before the frame was pushed
+    uint16_t remaining = 0;    // Candidates not tried yet
+    uint8_t cell = 0;
+    uint8_t placed = 0; // Digit on the board now, 0 = none
+  };
+
+  struct SearchState {
+    std::array<SearchFrame, 81> frames;
+    int depth = 0;         // Frames in use
+    bool expand = true;    // The current position is not expanded yet
+    bool finished = false; // Tree exhausted or solution limit reached
+    long long nodes = 0;   // Positions expanded
+    long long solutions = 0;
+  };
+
+  struct SearchOptions {
+    long long limit = 0; // Finish at this many solutions; 0 = all
+    // Called on every solution; false stops the search (still resumable).
+    std::function<bool(const SudokuBoard &)> visit;
+    // Randomizes MRV ties and value order; null = first cell, ascending.
+    std::mt19937 *rng = nullptr;
+    long long maxNodes = 0; // Stop after this many more expansions; 0 = none
+    bool observe = false;   // Feed step callback, trace and heatmap
+  };
+
+  enum class SearchStop { FINISHED, VISITOR, CANCELLED, BUDGET };
+
+  // Runs state on this solver's board until it finishes or stops. When
+  // the tree is exhausted the board is back where the search started; when
+  // the limit is reached it keeps the path to the last solution (the
+  // solution itself unless a cached count supplied it). Any other stop
+  // leaves a state that a later call continues exactly. The board must
+  // hold state's path.
+  SearchStop search(SearchState &state, const SearchOptions &options);
+
+  // Takes state's guessed digits off the board and resets it.
+  void abandonSearch(SearchState &state);
+
+  // Pre-solve cost prediction. Knuth's estimator: each probe follows one
+  // random path down the MRV tree (after the logic pass, as solve() would)
+  // and sums the products of the branching factors along it; the mean over
+  // probes is an unbiased estimate of the size of the exhaustive tree, and
+  // the same weights at solved leaves estimate the number of solutions.
+  // Solving stops at the first solution, so the prediction divides the tree
+  // among the solutions. It ranks puzzles well; it is not an exact count.
+  struct TreeEstimate {
+    double nodes = 0.0;         // Predicted nodes to the first solution
+    double seconds = 0.0;       // nodes * kEstimatedSecondsPerNode
+    double treeNodes = 0.0;     // Estimated size of the exhaustive MRV tree
+    double solutions = 0.0;     // Estimated number of solutions
+    int logicPlacements = 0;    // Cells filled by the logic pass
+    double meanBranching = 0.0; // Mean MRV candidate count along probes
+    double meanDepth = 0.0;     // Mean probe length
+    int deadEndProbes = 0;      // Probes that hit a cell with no candidates
+  };
+
+  // Rough MRV cost per node (about 2 us measured over a 2000-puzzle batch);
+  // used for TreeEstimate.seconds.
+  static constexpr double kEstimatedSecondsPerNode = 2.0e-6;
+
+  // Trees that look small after a few probes end early. The board, counters
+  // and callbacks are left unchanged.
+  TreeEstimate estimateSearch(int probes = 16, unsigned int probeSeed = 1);
+
   long long getRecursionCount() const;
   long long getBacktrackCount() const;
   long long getLogicCount() const;
@@ -46,10 +180,36 @@ private:
   long long backtrackCount = 0;
   long long logicCount = 0;
   Mode currentMode = Mode::HYBRID;
+  TraceWriter *traceWriter = nullptr;
+  const std::atomic<bool> *cancelFlag = nullptr;
+  TranspositionTable *transpositionTable = nullptr;
+  Heatmap *heatmap = nullptr;
+
+  RestartSchedule restartSchedule = RestartSchedule::LUBY;
+  long long restartBaseNodes = 100;
+  double restartGrowth = 1.5;
+  unsigned int seed = 0;
+  unsigned int winningSeed = 0;
+  int restartCount = 0;
+  long long nodeLimit = 0; // Per restart run; 0 = unlimited
+  bool limitReached = false;
+
+  int depth = 0; // Current search depth (0 = logic / root)
+
+  bool isCancelled() const {
+    return cancelFlag && cancelFlag->load(std::memory_order_relaxed);
+  }
 
-  bool solveRecursive();
-  bool solveRecursiveRandomized(std::mt19937 &g);
-  bool findBestCell(int &row, int &col); // MRV Heuristic
+  // First solution; unwinds the board if there is none. observe turns on
+  // step callbacks, tracing and the heatmap.
+  bool searchFirst(std::mt19937 *rng, bool observe = true);
+  void undoGuess(SearchFrame &frame, int frameDepth, bool observe);
+  bool solveWithRestarts();
+  bool solveSat();
+  // MRV Heuristic. With an rng, ties are broken uniformly at random.
+  // bestMask, if given, receives the chosen cell's candidate mask.
+  bool findBestCell(int &row, int &col, std::mt19937 *rng = nullptr,
+                    int *bestMask = nullptr);
 
   // Human-like techniques
   bool applyNakedSingles();
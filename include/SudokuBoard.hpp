@@ -1,49 +1,196 @@
 #ifndef SUDOKU_BOARD_HPP
 #define SUDOKU_BOARD_HPP
 
+#include "SudokuTables.hpp"
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <string_view>
 #include <vector>
 
-
-class SudokuBoard {
+// Compact, trivially copyable layout: one byte per cell, a 128-bit fixed-cell
+// set and 16-bit candidate masks fit in three cache lines, so copying or
+// comparing a board is a plain memcpy / memcmp.
+//
+// Everything but the vector/string/stream helpers is constexpr, so fixed
+// puzzles can be built, searched (ConstexprSolver.hpp) and checked in
+// constant expressions.
+class alignas(64) SudokuBoard {
 public:
-  SudokuBoard();
+  constexpr SudokuBoard() = default;
 
   // Load a 9x9 board. 0 represents empty cells.
   void loadBoard(const std::vector<std::vector<int>> &grid);
 
+  // Load from an 81-character row-major string ('1'-'9', '0' or '.' empty).
+  // Returns false (board untouched) if the string is malformed.
+  constexpr bool loadFromString(std::string_view text);
+
+  // 81-character row-major string, '0' for empty cells.
+  std::string toString() const;
+
   // Check if placing number at (row, col) is valid
-  bool isValid(int row, int col, int number) const;
+  constexpr bool isValid(int row, int col, int number) const;
 
   // Place a number at (row, col)
-  void placeNumber(int row, int col, int number);
+  constexpr void placeNumber(int row, int col, int number);
 
   // Remove a number from (row, col)
-  void removeNumber(int row, int col);
+  constexpr void removeNumber(int row, int col);
 
   // Check if the board is completely filled and valid
-  bool isComplete() const;
+  constexpr bool isComplete() const;
 
   // Check if a cell is fixed (initially given)
-  bool isFixed(int row, int col) const;
+  constexpr bool isFixed(int row, int col) const;
 
   // Print the board to console
   void printBoard() const;
 
   // Get value at (row, col)
-  int getValue(int row, int col) const;
+  constexpr int getValue(int row, int col) const;
+
+  // Bitmask (bits 1-9) of digits that (row, col) could take now.
+  constexpr uint16_t getCandidates(int row, int col) const;
+
+  // 64-bit Zobrist hash of the cell values, updated incrementally by
+  // placeNumber/removeNumber. Equal positions hash equally regardless of the
+  // order in which their digits were placed.
+  constexpr uint64_t getHash() const;
+
+  // Same digits and same givens.
+  bool operator==(const SudokuBoard &other) const;
+  bool operator!=(const SudokuBoard &other) const;
 
 private:
-  int grid[9][9];
-  bool fixed[9][9];
+  uint64_t hash = 0;
+  uint64_t fixedBits[2] = {}; // Bit (row * 9 + col) set for givens
 
   // Bitmasks for O(1) checking
   // bits 1-9 are used. 0th bit unused (or ignored).
-  int rowMask[9];
-  int colMask[9];
-  int boxMask[3][3];
+  uint16_t rowMask[9] = {};
+  uint16_t colMask[9] = {};
+  uint16_t boxMask[9] = {}; // Indexed by kSudokuTables.boxOf[cell]
+
+  uint8_t cells[81] = {}; // Row-major, 0 = empty
 
-  void reset();
+  constexpr void reset();
+  constexpr void setFixed(int row, int col);
+  // Out of line; never reached in a constant expression that succeeds.
+  static void warnFixed(const char *action, int row, int col);
 };
 
+constexpr void SudokuBoard::reset() { *this = SudokuBoard(); }
+
+constexpr bool SudokuBoard::loadFromString(std::string_view text) {
+  if (text.size() < 81)
+    return false;
+  for (int i = 0; i < 81; ++i) {
+    char ch = text[i];
+    if (!(ch >= '0' && ch <= '9') && ch != '.')
+      return false;
+  }
+  reset();
+  for (int i = 0; i < 81; ++i) {
+    if (text[i] >= '1' && text[i] <= '9') {
+      int row = kSudokuTables.rowOf[i], col = kSudokuTables.colOf[i];
+      placeNumber(row, col, text[i] - '0');
+      setFixed(row, col);
+    }
+  }
+  return true;
+}
+
+constexpr bool SudokuBoard::isValid(int row, int col, int number) const {
+  // Check boundaries
+  if (row < 0 || row >= 9 || col < 0 || col >= 9 || number < 1 || number > 9) {
+    return false;
+  }
+
+  // The masks include whatever (row, col) holds now, so a cell already
+  // holding number is "valid", and asking about a different digit for a
+  // filled cell is only meaningful once the caller has cleared it. Solvers
+  // only ask about empty cells.
+  if (cells[row * 9 + col] == number)
+    return true;
+
+  return (getCandidates(row, col) & (1 << number)) != 0;
+}
+
+constexpr uint16_t SudokuBoard::getCandidates(int row, int col) const {
+  uint16_t used = rowMask[row] | colMask[col] |
+                  boxMask[kSudokuTables.boxOf[row * 9 + col]];
+  return static_cast<uint16_t>(~used & 0x3FE);
+}
+
+constexpr void SudokuBoard::placeNumber(int row, int col, int number) {
+  if (isFixed(row, col)) {
+    warnFixed("modify", row, col);
+    return;
+  }
+
+  // If there's already a number, remove it first to update masks correctly
+  int cell = row * 9 + col;
+  if (cells[cell] != 0) {
+    removeNumber(row, col);
+  }
+
+  if (number == 0)
+    return; // effectively remove
+
+  cells[cell] = static_cast<uint8_t>(number);
+  hash ^= kSudokuTables.zobrist[cell][number];
+  uint16_t val = static_cast<uint16_t>(1 << number);
+
+  rowMask[row] |= val;
+  colMask[col] |= val;
+  boxMask[kSudokuTables.boxOf[cell]] |= val;
+}
+
+constexpr void SudokuBoard::removeNumber(int row, int col) {
+  if (isFixed(row, col)) {
+    warnFixed("clear", row, col);
+    return;
+  }
+
+  int cell = row * 9 + col;
+  int number = cells[cell];
+  if (number == 0)
+    return;
+
+  cells[cell] = 0;
+  hash ^= kSudokuTables.zobrist[cell][number];
+  uint16_t val = static_cast<uint16_t>(~(1 << number));
+
+  rowMask[row] &= val;
+  colMask[col] &= val;
+  boxMask[kSudokuTables.boxOf[cell]] &= val;
+}
+
+constexpr bool SudokuBoard::isComplete() const {
+  for (int i = 0; i < 81; ++i) {
+    if (cells[i] == 0)
+      return false;
+  }
+  // Theoretically should also check strictly valid, but if we only used isValid
+  // to place, it should be valid.
+  return true;
+}
+
+constexpr bool SudokuBoard::isFixed(int row, int col) const {
+  int cell = row * 9 + col;
+  return (fixedBits[cell >> 6] >> (cell & 63)) & 1;
+}
+
+constexpr void SudokuBoard::setFixed(int row, int col) {
+  int cell = row * 9 + col;
+  fixedBits[cell >> 6] |= uint64_t(1) << (cell & 63);
+}
+
+constexpr int SudokuBoard::getValue(int row, int col) const {
+  return cells[row * 9 + col];
+}
+
+constexpr uint64_t SudokuBoard::getHash() const { return hash; }
+
 #endif // SUDOKU_BOARD_HPP
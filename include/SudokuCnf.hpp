@@ -0,0 +1,45 @@
+#ifndef SUDOKU_CNF_HPP
+#define SUDOKU_CNF_HPP
+
+#include "SatSolver.hpp"
+#include <vector>
+
+// CNF encoding of an N x N Sudoku (N = boxSize^2) for CdclSolver.
+//
+// Variable x(r, c, v) is true when cell (r, c) holds v. Every cell, row,
+// column and box gets an at-least-one clause per value plus pairwise
+// at-most-one clauses; filled cells become unit clauses. encodeUnits() takes
+// the units from the caller, for rule sets with other or extra units
+// (VariantSolver's SAT mode).
+class SudokuCnf {
+public:
+  explicit SudokuCnf(int boxSize = 3);
+
+  int size() const;
+  int variable(int row, int col, int value) const; // value is 1-based
+
+  // grid is row-major with size()^2 entries, 0 = empty.
+  // Returns false if the givens already contradict each other.
+  bool encode(CdclSolver &sat, const std::vector<int> &grid) const;
+  // Same with arbitrary all-different units of size() cells each (row-major
+  // cell indices) in place of the rows, columns and boxes.
+  bool encodeUnits(CdclSolver &sat, const std::vector<std::vector<int>> &units,
+                   const std::vector<int> &grid) const;
+
+  // Reads the model of a satisfied solver back into grid.
+  void decode(const CdclSolver &sat, std::vector<int> &grid) const;
+
+  // Convenience: encode, solve and decode in one call. Works for any box
+  // size (3 = 9x9, 4 = 16x16, 5 = 25x25).
+  static CdclSolver::Result solveGrid(int boxSize, std::vector<int> &grid,
+                                      const std::atomic<bool> *cancelFlag =
+                                          nullptr);
+
+private:
+  int boxSize;
+  int n;
+
+  void addExactlyOne(CdclSolver &sat, const std::vector<int> &vars) const;
+};
+
+#endif // SUDOKU_CNF_HPP
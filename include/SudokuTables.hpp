@@ -0,0 +1,73 @@
+#ifndef SUDOKU_TABLES_HPP
+#define SUDOKU_TABLES_HPP
+
+#include <cstdint>
+
+// Cell geometry and Zobrist keys, generated at compile time and stored in
+// read-only data. Cells are row-major 0-80; units are rows 0-8, columns 9-17
+// and boxes 18-26 (box b covers rows 3 * (b / 3).. and columns 3 * (b % 3)..).
+struct SudokuTables {
+  uint8_t rowOf[81];
+  uint8_t colOf[81];
+  uint8_t boxOf[81];
+  uint8_t unitsOf[81][3]; // Row, column and box unit of each cell
+  uint8_t unitCells[27][9];
+  uint8_t peers[81][20]; // The other cells sharing a unit, ascending
+
+  // One random key per (cell, digit); digit 0 is unused.
+  uint64_t zobrist[81][10];
+};
+
+constexpr SudokuTables makeSudokuTables() {
+  SudokuTables t{};
+  for (int cell = 0; cell < 81; ++cell) {
+    int row = cell / 9, col = cell % 9, box = (row / 3) * 3 + col / 3;
+    t.rowOf[cell] = static_cast<uint8_t>(row);
+    t.colOf[cell] = static_cast<uint8_t>(col);
+    t.boxOf[cell] = static_cast<uint8_t>(box);
+    t.unitsOf[cell][0] = static_cast<uint8_t>(row);
+    t.unitsOf[cell][1] = static_cast<uint8_t>(9 + col);
+    t.unitsOf[cell][2] = static_cast<uint8_t>(18 + box);
+  }
+  for (int i = 0; i < 9; ++i) {
+    for (int j = 0; j < 9; ++j) {
+      t.unitCells[i][j] = static_cast<uint8_t>(i * 9 + j);
+      t.unitCells[9 + i][j] = static_cast<uint8_t>(j * 9 + i);
+      t.unitCells[18 + i][j] = static_cast<uint8_t>(
+          ((i / 3) * 3 + j / 3) * 9 + (i % 3) * 3 + j % 3);
+    }
+  }
+  for (int cell = 0; cell < 81; ++cell) {
+    int count = 0;
+    for (int other = 0; other < 81; ++other) {
+      if (other != cell && (t.rowOf[other] == t.rowOf[cell] ||
+                            t.colOf[other] == t.colOf[cell] ||
+                            t.boxOf[other] == t.boxOf[cell]))
+        t.peers[cell][count++] = static_cast<uint8_t>(other);
+    }
+  }
+
+  // splitmix64, so the keys are identical on every run and platform
+  uint64_t state = 0x5D0C0B0A12345678ULL;
+  for (int cell = 0; cell < 81; ++cell) {
+    for (int n = 0; n < 10; ++n) {
+      state += 0x9E3779B97F4A7C15ULL;
+      uint64_t z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      t.zobrist[cell][n] = z ^ (z >> 31);
+    }
+  }
+  return t;
+}
+
+inline constexpr SudokuTables kSudokuTables = makeSudokuTables();
+
+static_assert(kSudokuTables.boxOf[80] == 8 && kSudokuTables.boxOf[30] == 4,
+              "box numbering");
+static_assert(kSudokuTables.unitCells[22][4] == 40, "centre of the centre box");
+static_assert(kSudokuTables.peers[0][19] == 72 &&
+                  kSudokuTables.peers[80][0] == 8,
+              "every cell has 20 peers");
+
+#endif // SUDOKU_TABLES_HPP
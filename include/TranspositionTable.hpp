@@ -0,0 +1,47 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bounded, always-replace hash table keyed by SudokuBoard::getHash().
+//
+// Each entry records the exact number of solutions below a position; a count
+// of 0 marks a dead subproblem. Only complete results may be stored: a
+// search that was cut short (node limit, cancellation, solution limit) must
+// not record its partial count.
+//
+// Not thread-safe; give each solver thread its own table.
+class TranspositionTable {
+public:
+  // Capacity is rounded up to a power of two (default: 1M entries, 16 MB).
+  explicit TranspositionTable(size_t capacity = 1 << 20);
+
+  void clear();
+
+  void storeDead(uint64_t key);
+  bool isDead(uint64_t key);
+
+  void storeCount(uint64_t key, long long count);
+  bool lookupCount(uint64_t key, long long &count);
+
+  size_t getCapacity() const;
+  long long getHits() const;
+  long long getProbes() const;
+
+private:
+  struct Entry {
+    uint64_t key = 0; // 0 = empty
+    long long count = 0;
+  };
+
+  std::vector<Entry> entries;
+  size_t mask;
+  long long hits = 0;
+  long long probes = 0;
+
+  static uint64_t normalize(uint64_t key) { return key ? key : 1; }
+};
+
+#endif // TRANSPOSITION_TABLE_HPP
@@ -0,0 +1,296 @@
+#ifndef VARIANT_SOLVER_HPP
+#define VARIANT_SOLVER_HPP
+
+#include "Solver.hpp"
+#include "SudokuCnf.hpp"
+#include "Variants.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Board whose units come from a compile-time rule set (see Variants.hpp).
+// Cells are addressed by row-major index (row * 9 + col).
+template <class Rules> class VariantBoard {
+public:
+  explicit VariantBoard(const Rules &rules = Rules()) : rules(rules) {
+    reset();
+  }
+
+  // Same format as SudokuBoard::loadFromString. Givens become fixed.
+  bool loadFromString(const std::string &text) {
+    if (text.size() < 81)
+      return false;
+    for (int i = 0; i < 81; ++i) {
+      char ch = text[i];
+      if (!(ch >= '0' && ch <= '9') && ch != '.')
+        return false;
+    }
+    reset();
+    for (int i = 0; i < 81; ++i) {
+      if (text[i] >= '1' && text[i] <= '9') {
+        placeNumber(i, text[i] - '0');
+        fixed[i] = true;
+      }
+    }
+    return true;
+  }
+
+  std::string toString() const {
+    std::string out(81, '0');
+    for (int i = 0; i < 81; ++i)
+      out[i] = static_cast<char>('0' + cells[i]);
+    return out;
+  }
+
+  // Bitmask (bits 1-9) of digits that may go in an empty cell.
+  uint16_t getCandidates(int cell) const {
+    uint16_t used = 0;
+    const int8_t *units = rules.unitsOf(cell);
+    for (int k = 0; k < rules.unitCountOf(cell); ++k)
+      used |= unitMask[units[k]];
+    uint16_t mask = kAllDigitsMask & static_cast<uint16_t>(~used);
+    if constexpr (Rules::kHasCages)
+      mask &= rules.cageCandidates(cells, cell);
+    return mask;
+  }
+
+  bool isValid(int cell, int number) const {
+    if (cell < 0 || cell >= 81 || number < 1 || number > 9)
+      return false;
+    if (cells[cell] == number)
+      return true;
+    return (getCandidates(cell) & (1 << number)) != 0;
+  }
+
+  void placeNumber(int cell, int number) {
+    if (fixed[cell])
+      return;
+    if (cells[cell] != 0)
+      removeNumber(cell);
+    if (number == 0)
+      return;
+
+    cells[cell] = static_cast<uint8_t>(number);
+    uint16_t bit = static_cast<uint16_t>(1 << number);
+    const int8_t *units = rules.unitsOf(cell);
+    for (int k = 0; k < rules.unitCountOf(cell); ++k)
+      unitMask[units[k]] |= bit;
+  }
+
+  void removeNumber(int cell) {
+    if (fixed[cell] || cells[cell] == 0)
+      return;
+
+    uint16_t bit = static_cast<uint16_t>(1 << cells[cell]);
+    cells[cell] = 0;
+    const int8_t *units = rules.unitsOf(cell);
+    for (int k = 0; k < rules.unitCountOf(cell); ++k)
+      unitMask[units[k]] &= static_cast<uint16_t>(~bit);
+  }
+
+  int getValue(int cell) const { return cells[cell]; }
+  bool isFixed(int cell) const { return fixed[cell]; }
+
+  bool isComplete() const {
+    for (int i = 0; i < 81; ++i) {
+      if (cells[i] == 0)
+        return false;
+    }
+    return true;
+  }
+
+  const Rules &getRules() const { return rules; }
+
+private:
+  Rules rules;
+  uint8_t cells[81];
+  bool fixed[81];
+  uint16_t unitMask[Rules::kUnitCount];
+
+  void reset() {
+    for (int i = 0; i < 81; ++i) {
+      cells[i] = 0;
+      fixed[i] = false;
+    }
+    for (int u = 0; u < Rules::kUnitCount; ++u)
+      unitMask[u] = 0;
+  }
+};
+
+// Logic (naked / hidden singles over every unit of the rule set, with cage
+// pruning for killer) followed by MRV backtracking. Mirrors Solver's modes;
+// SAT hands the rule set's units to the CDCL engine (SudokuCnf). Killer
+// cage sums have no CNF encoding, so killer boards search in SAT mode.
+template <class Rules> class VariantSolver {
+public:
+  explicit VariantSolver(VariantBoard<Rules> &board) : board(board) {}
+
+  void setMode(Solver::Mode mode) { currentMode = mode; }
+  Solver::Mode getMode() const { return currentMode; }
+
+  bool solve() {
+    recursionCount = 0;
+    backtrackCount = 0;
+    logicCount = 0;
+
+    if constexpr (!Rules::kHasCages) {
+      if (currentMode == Solver::Mode::SAT)
+        return solveSat();
+    }
+
+    bool useLogic = currentMode != Solver::Mode::BACKTRACK_ONLY;
+    if (useLogic) {
+      solveHumanistic();
+      if (currentMode == Solver::Mode::LOGIC_ONLY)
+        return board.isComplete();
+    }
+    if (board.isComplete())
+      return true;
+    return solveRecursive();
+  }
+
+  bool solveHumanistic() {
+    while (applyNakedSingles() || applyHiddenSingles()) {
+    }
+    return board.isComplete();
+  }
+
+  long long getRecursionCount() const { return recursionCount; }
+  long long getBacktrackCount() const { return backtrackCount; }
+  long long getLogicCount() const { return logicCount; }
+
+private:
+  VariantBoard<Rules> &board;
+  Solver::Mode currentMode = Solver::Mode::HYBRID;
+
+  long long recursionCount = 0;
+  long long backtrackCount = 0;
+  long long logicCount = 0;
+
+  static int countSetBits(uint16_t n) {
+    int count = 0;
+    while (n) {
+      n &= static_cast<uint16_t>(n - 1);
+      count++;
+    }
+    return count;
+  }
+
+  static int lowestDigit(uint16_t mask) {
+    for (int n = 1; n <= 9; ++n) {
+      if (mask & (1 << n))
+        return n;
+    }
+    return 0;
+  }
+
+  bool applyNakedSingles() {
+    for (int cell = 0; cell < 81; ++cell) {
+      if (board.getValue(cell) != 0)
+        continue;
+      uint16_t mask = board.getCandidates(cell);
+      if (countSetBits(mask) == 1) {
+        board.placeNumber(cell, lowestDigit(mask));
+        logicCount++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool applyHiddenSingles() {
+    const Rules &rules = board.getRules();
+    for (int u = 0; u < Rules::kUnitCount; ++u) {
+      int counts[10] = {0};
+      int lastPos[10] = {0};
+      for (int cell : rules.unit(u)) {
+        if (board.getValue(cell) != 0)
+          continue;
+        uint16_t mask = board.getCandidates(cell);
+        for (int n = 1; n <= 9; ++n) {
+          if (mask & (1 << n)) {
+            counts[n]++;
+            lastPos[n] = cell;
+          }
+        }
+      }
+      for (int n = 1; n <= 9; ++n) {
+        if (counts[n] == 1) {
+          board.placeNumber(lastPos[n], n);
+          logicCount++;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // MRV: empty cell with the fewest candidates; -1 when the board is full.
+  int findBestCell(uint16_t &bestMask) {
+    int best = -1;
+    int minCandidates = 10;
+    for (int cell = 0; cell < 81; ++cell) {
+      if (board.getValue(cell) != 0)
+        continue;
+      uint16_t mask = board.getCandidates(cell);
+      int count = countSetBits(mask);
+      if (count < minCandidates) {
+        minCandidates = count;
+        best = cell;
+        bestMask = mask;
+        if (count <= 1)
+          break;
+      }
+    }
+    return best;
+  }
+
+  // Counters report CDCL decisions / conflicts, as in Solver's SAT mode.
+  bool solveSat() {
+    const Rules &rules = board.getRules();
+    std::vector<std::vector<int>> units(Rules::kUnitCount);
+    for (int u = 0; u < Rules::kUnitCount; ++u)
+      units[u].assign(rules.unit(u).begin(), rules.unit(u).end());
+    std::vector<int> grid(81);
+    for (int i = 0; i < 81; ++i)
+      grid[i] = board.getValue(i);
+
+    SudokuCnf cnf(3);
+    CdclSolver sat;
+    CdclSolver::Result result = cnf.encodeUnits(sat, units, grid)
+                                    ? sat.solve()
+                                    : CdclSolver::Result::UNSATISFIABLE;
+    recursionCount = sat.getDecisions();
+    backtrackCount = sat.getConflicts();
+    if (result != CdclSolver::Result::SATISFIABLE)
+      return false;
+
+    cnf.decode(sat, grid);
+    for (int i = 0; i < 81; ++i) {
+      if (board.getValue(i) == 0)
+        board.placeNumber(i, grid[i]);
+    }
+    return board.isComplete();
+  }
+
+  bool solveRecursive() {
+    recursionCount++;
+    uint16_t mask = 0;
+    int cell = findBestCell(mask);
+    if (cell < 0)
+      return true;
+
+    for (int num = 1; num <= 9; ++num) {
+      if (!(mask & (1 << num)))
+        continue;
+      board.placeNumber(cell, num);
+      if (solveRecursive())
+        return true;
+      board.removeNumber(cell);
+      backtrackCount++;
+    }
+    return false;
+  }
+};
+
+#endif // VARIANT_SOLVER_HPP
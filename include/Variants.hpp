@@ -0,0 +1,205 @@
+#ifndef VARIANTS_HPP
+#define VARIANTS_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Constraint sets for Sudoku variants, selected at compile time as the
+// template argument of VariantBoard / VariantSolver.
+//
+// A rule set provides:
+//   kUnitCount                - number of all-different units of 9 cells
+//   unit(u)                   - the 9 cells of unit u (row-major indices)
+//   unitsOf(cell), unitCountOf(cell)
+//   kHasCages                 - whether cageCandidates() restricts cells
+//   cageCandidates(cells, c)  - extra candidate mask for cell c (killer only)
+//
+// The classic game keeps using SudokuBoard / Solver directly. ClassicRules
+// gives the template the same units so `SolverTest variants` can check
+// VariantSolver against Solver.
+
+constexpr uint16_t kAllDigitsMask = 0x3FE; // bits 1-9
+
+template <int UnitCount> class UnitRules {
+public:
+  static constexpr int kUnitCount = UnitCount;
+  static constexpr int kMaxUnitsPerCell = 5; // Centre cell of X-Sudoku
+  static constexpr bool kHasCages = false;
+
+  const std::array<int, 9> &unit(int u) const { return units[u]; }
+  const int8_t *unitsOf(int cell) const { return cellUnits[cell].data(); }
+  int unitCountOf(int cell) const { return cellUnitCount[cell]; }
+
+  uint16_t cageCandidates(const uint8_t *, int) const { return kAllDigitsMask; }
+
+protected:
+  std::array<std::array<int, 9>, UnitCount> units{};
+  std::array<std::array<int8_t, kMaxUnitsPerCell>, 81> cellUnits{};
+  std::array<int8_t, 81> cellUnitCount{};
+
+  // Rows 0-8 and columns 9-17 are shared by every variant.
+  void addRowsAndCols() {
+    for (int i = 0; i < 9; ++i) {
+      for (int j = 0; j < 9; ++j) {
+        units[i][j] = i * 9 + j;
+        units[9 + i][j] = j * 9 + i;
+      }
+    }
+  }
+
+  void addBoxes(int first) {
+    for (int b = 0; b < 9; ++b) {
+      for (int k = 0; k < 9; ++k) {
+        units[first + b][k] = ((b / 3) * 3 + k / 3) * 9 + (b % 3) * 3 + k % 3;
+      }
+    }
+  }
+
+  void indexCells() {
+    cellUnitCount.fill(0);
+    for (int u = 0; u < UnitCount; ++u) {
+      for (int cell : units[u])
+        cellUnits[cell][cellUnitCount[cell]++] = static_cast<int8_t>(u);
+    }
+  }
+};
+
+// Rows, columns and 3x3 boxes.
+class ClassicRules : public UnitRules<27> {
+public:
+  ClassicRules() {
+    addRowsAndCols();
+    addBoxes(18);
+    indexCells();
+  }
+};
+
+// X-Sudoku: classic units plus both main diagonals.
+class DiagonalRules : public UnitRules<29> {
+public:
+  DiagonalRules() {
+    addRowsAndCols();
+    addBoxes(18);
+    for (int k = 0; k < 9; ++k) {
+      units[27][k] = k * 9 + k;
+      units[28][k] = k * 9 + (8 - k);
+    }
+    indexCells();
+  }
+};
+
+// Jigsaw: the 3x3 boxes are replaced by nine irregular regions.
+class JigsawRules : public UnitRules<27> {
+public:
+  // regionOf[cell] is the region (0-8) of each cell; every region must
+  // contain exactly 9 cells. isValidLayout() reports malformed input.
+  explicit JigsawRules(const std::array<int, 81> &regionOf) {
+    addRowsAndCols();
+    std::array<int, 9> fill{};
+    for (int cell = 0; cell < 81; ++cell) {
+      int r = regionOf[cell];
+      if (r < 0 || r >= 9 || fill[r] >= 9) {
+        valid = false;
+        continue;
+      }
+      units[18 + r][fill[r]++] = cell;
+    }
+    for (int count : fill) {
+      if (count != 9)
+        valid = false;
+    }
+    if (!valid)
+      addBoxes(18); // Keep the unit table well-formed
+    indexCells();
+  }
+
+  bool isValidLayout() const { return valid; }
+
+private:
+  bool valid = true;
+};
+
+// Killer: classic units plus cages whose digits are distinct and add up to
+// the cage sum. Cages prune candidates to digits that appear in at least one
+// combination completing the remaining sum.
+class KillerRules : public UnitRules<27> {
+public:
+  static constexpr bool kHasCages = true;
+
+  struct Cage {
+    std::vector<int> cells;
+    int sum = 0;
+  };
+
+  explicit KillerRules(const std::vector<Cage> &cageList) : cages(cageList) {
+    addRowsAndCols();
+    addBoxes(18);
+    indexCells();
+
+    cageOf.fill(-1);
+    for (size_t i = 0; i < cages.size(); ++i) {
+      for (int cell : cages[i].cells)
+        cageOf[cell] = static_cast<int>(i);
+    }
+  }
+
+  uint16_t cageCandidates(const uint8_t *cells, int cell) const {
+    int c = cageOf[cell];
+    if (c < 0)
+      return kAllDigitsMask;
+
+    const Cage &cage = cages[c];
+    uint16_t used = 0;
+    int remaining = cage.sum;
+    int open = 0;
+    for (int member : cage.cells) {
+      if (cells[member] != 0) {
+        used |= static_cast<uint16_t>(1 << cells[member]);
+        remaining -= cells[member];
+      } else {
+        open++;
+      }
+    }
+    if (open == 0 || remaining < 0 || remaining > 45)
+      return 0;
+
+    uint16_t allowed = 0;
+    for (uint16_t combo : comboTable().bySizeAndSum[open][remaining]) {
+      if (!(combo & used))
+        allowed |= combo;
+    }
+    return allowed;
+  }
+
+  const std::vector<Cage> &getCages() const { return cages; }
+
+private:
+  // Every digit subset grouped by (size, sum); shared by all rule copies.
+  struct ComboTable {
+    std::vector<uint16_t> bySizeAndSum[10][46];
+
+    ComboTable() {
+      for (int mask = 0; mask < 512; ++mask) {
+        int size = 0, sum = 0;
+        for (int d = 0; d < 9; ++d) {
+          if (mask & (1 << d)) {
+            size++;
+            sum += d + 1;
+          }
+        }
+        bySizeAndSum[size][sum].push_back(static_cast<uint16_t>(mask << 1));
+      }
+    }
+  };
+
+  static const ComboTable &comboTable() {
+    static const ComboTable table;
+    return table;
+  }
+
+  std::vector<Cage> cages;
+  std::array<int, 81> cageOf{};
+};
+
+#endif // VARIANTS_HPP
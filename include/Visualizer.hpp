@@ -1,13 +1,18 @@
 #ifndef VISUALIZER_HPP
 #define VISUALIZER_HPP
 
+#include "EngineRace.hpp"
+#include "EngineSelector.hpp"
 #include "Generator.hpp"
+#include "HintEngine.hpp"
+#include "PuzzlePool.hpp"
 #include "Solver.hpp"
 #include "SudokuBoard.hpp"
 #include <SFML/Graphics.hpp>
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 
 class Visualizer {
@@ -20,10 +25,27 @@ private:
   SudokuBoard &board;
   Solver &solver;
   Generator generator;
+  PuzzlePool puzzlePool; // G / M pop from here; generator is the fallback
+  EngineSelector engineSelector; // '6' picks the mode for the current board
   sf::RenderWindow window;
   sf::Font font;
   SudokuBoard initialBoard;
 
+  // Play-mode move checking and hints; reloaded whenever the board is
+  // replaced, and lazily after the automatic solver has changed it.
+  HintEngine hints;
+  bool hintsStale{false};
+
+  // Search heatmap overlay ('O' cycles the counter shown) and live rates.
+  // The depth graph keeps one sample per frame of the current solve.
+  enum class Overlay { OFF, BRANCHES, BACKTRACKS, CHANGES };
+  Overlay overlay{Overlay::OFF};
+  Solver::Heatmap heatmap;
+  std::vector<int> depthHistory;
+  sf::Clock rateClock;
+  long long rateNodes{0};
+  double nodesPerSecond{0.0};
+
   std::thread solverThread;
   std::atomic<bool> solving{false};
   // We use mutex potentially, but for simple visualization we might skip
@@ -46,11 +68,21 @@ private:
   sf::Clock timer;
   sf::Time elapsed;
 
+  // Race view ('V'): every engine of the race on its own mini-board,
+  // solving a copy of the current board at full speed.
+  EngineRace race;
+  bool raceView{false};
+
   void processEvents();
   void render();
   void drawGrid();
   void drawNumbers();
   void drawInfo();
+  void drawDepthGraph();
+  void drawRace();
+  void drawMiniBoard(const SudokuBoard &mini, float x, float y,
+                     float cellSize);
+  void sampleSearchStats();
   void checkWinCondition(); // Check if user has won
 
   void startSolving();
@@ -0,0 +1,275 @@
+#include "BatchSolver.hpp"
+#include "GridVerifier.hpp"
+#include "LockstepSolver.hpp"
+#include "SudokuBoard.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+namespace {
+// Puzzles predicted below this are solved during the estimation pass; their
+// place in the schedule does not matter.
+constexpr double kSolveInlineNodes = 1000.0;
+
+// Runs body(i) for i in [0, count) on `threads` threads, handing out indices
+// in order.
+template <class Body> void parallelFor(int threads, size_t count, Body body) {
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++)
+      body(i);
+  };
+  std::vector<std::thread> pool;
+  for (int t = 1; t < threads; ++t)
+    pool.emplace_back(worker);
+  worker();
+  for (std::thread &t : pool)
+    t.join();
+}
+} // namespace
+
+BatchSolver::BatchSolver(Engine engine) : engine(engine) {}
+
+void BatchSolver::setEngine(Engine e) { engine = e; }
+BatchSolver::Engine BatchSolver::getEngine() const { return engine; }
+void BatchSolver::setMode(Solver::Mode m) { mode = m; }
+const BatchSolver::Stats &BatchSolver::getStats() const { return stats; }
+void BatchSolver::setPortfolio(const Portfolio &p) { portfolio = p; }
+const Portfolio &BatchSolver::getPortfolio() const { return portfolio; }
+void BatchSolver::setThreads(int threads) { threadCount = threads; }
+void BatchSolver::setPortfolioThreshold(double nodes) {
+  portfolioThreshold = nodes;
+}
+void BatchSolver::setVerify(bool verify) { verifySolutions = verify; }
+void BatchSolver::setSelector(const EngineSelector &s) { selector = s; }
+const EngineSelector &BatchSolver::getSelector() const { return selector; }
+
+bool BatchSolver::readPuzzleFile(const std::string &path,
+                                 std::vector<std::string> &puzzles) {
+  return readPuzzleRange(path, 0, -1, puzzles);
+}
+
+bool BatchSolver::readPuzzleRange(const std::string &path, long long begin,
+                                  long long end,
+                                  std::vector<std::string> &puzzles) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in || !in.seekg(begin))
+    return false;
+
+  std::string line;
+  while ((end < 0 || in.tellg() < end) && std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty() || line[0] == '#')
+      continue;
+    puzzles.push_back(line);
+  }
+  return true;
+}
+
+std::vector<BatchSolver::Result>
+BatchSolver::solveAll(const std::vector<std::string> &puzzles) {
+  stats = Stats();
+  std::vector<Result> results(puzzles.size());
+
+  auto start = std::chrono::steady_clock::now();
+  if (engine == Engine::LOCKSTEP)
+    solveLockstep(puzzles, results);
+  else if (engine == Engine::PORTFOLIO)
+    solvePortfolio(puzzles, results);
+  else if (engine == Engine::SCHEDULED)
+    solveScheduled(puzzles, results);
+  else if (engine == Engine::ADAPTIVE)
+    solveAdaptive(puzzles, results);
+  else
+    solveScalar(puzzles, results);
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  if (verifySolutions)
+    verifyResults(puzzles, results);
+
+  for (const Result &r : results) {
+    if (r.solved)
+      stats.solved++;
+    else
+      stats.failed++;
+  }
+  return results;
+}
+
+void BatchSolver::solveEach(
+    const std::vector<std::string> &puzzles, std::vector<Result> &results,
+    const std::function<bool(SudokuBoard &)> &solveBoard) {
+  for (size_t i = 0; i < puzzles.size(); ++i) {
+    SudokuBoard board;
+    if (!board.loadFromString(puzzles[i]))
+      continue;
+
+    if (solveBoard(board)) {
+      results[i].solution = board.toString();
+      results[i].solved = true;
+    }
+  }
+}
+
+void BatchSolver::solveScalar(const std::vector<std::string> &puzzles,
+                              std::vector<Result> &results) {
+  solveEach(puzzles, results, [this](SudokuBoard &board) {
+    Solver solver(board);
+    solver.setMode(mode);
+    bool ok = solver.solve() && board.isComplete();
+    stats.recursions += solver.getRecursionCount();
+    stats.backtracks += solver.getBacktrackCount();
+    return ok;
+  });
+}
+
+void BatchSolver::solveLockstep(const std::vector<std::string> &puzzles,
+                                std::vector<Result> &results) {
+  LockstepSolver lockstep;
+  std::vector<std::string> solutions;
+  lockstep.solveBatch(puzzles, solutions);
+  stats.propagated = lockstep.getStats().propagated;
+  stats.fallback = lockstep.getStats().fallback;
+
+  for (size_t i = 0; i < puzzles.size(); ++i) {
+    results[i].solved = !solutions[i].empty();
+    results[i].solution = std::move(solutions[i]);
+  }
+}
+
+void BatchSolver::solvePortfolio(const std::vector<std::string> &puzzles,
+                                 std::vector<Result> &results) {
+  stats.portfolioWins.assign(portfolio.getConfigs().size(), 0);
+  solveEach(puzzles, results, [this](SudokuBoard &board) {
+    Portfolio::Result race = portfolio.solve(board);
+    if (race.solved)
+      stats.portfolioWins[race.winnerIndex]++;
+    return race.solved;
+  });
+}
+
+void BatchSolver::solveScheduled(const std::vector<std::string> &puzzles,
+                                 std::vector<Result> &results) {
+  int threads = threadCount > 0
+                    ? threadCount
+                    : static_cast<int>(std::thread::hardware_concurrency());
+  threads = std::max(threads, 1);
+  stats.portfolioWins.assign(portfolio.getConfigs().size(), 0);
+
+  std::atomic<long long> recursions{0}, backtracks{0};
+  auto solveOne = [&](size_t i, SudokuBoard &board) {
+    Solver solver(board);
+    solver.setMode(mode);
+    bool ok = solver.solve() && board.isComplete();
+    recursions += solver.getRecursionCount();
+    backtracks += solver.getBacktrackCount();
+    if (ok) {
+      results[i].solution = board.toString();
+      results[i].solved = true;
+    }
+  };
+
+  // 1. Predict every puzzle's cost; cheap ones are finished right away
+  auto start = std::chrono::steady_clock::now();
+  std::vector<char> pending(puzzles.size(), 0);
+  parallelFor(threads, puzzles.size(), [&](size_t i) {
+    SudokuBoard board;
+    if (!board.loadFromString(puzzles[i]))
+      return;
+    Solver solver(board);
+    solver.setMode(mode);
+    results[i].estimatedNodes = solver.estimateSearch().nodes;
+    if (results[i].estimatedNodes < kSolveInlineNodes &&
+        results[i].estimatedNodes < portfolioThreshold)
+      solveOne(i, board);
+    else
+      pending[i] = 1;
+  });
+  stats.estimateSeconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+  std::vector<size_t> order;
+  for (size_t i = 0; i < puzzles.size(); ++i) {
+    if (pending[i])
+      order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return results[a].estimatedNodes > results[b].estimatedNodes;
+  });
+
+  // 2. Predicted-expensive puzzles get the whole machine via the portfolio
+  size_t first = 0;
+  while (first < order.size() &&
+         results[order[first]].estimatedNodes >= portfolioThreshold) {
+    size_t i = order[first++];
+    SudokuBoard board;
+    board.loadFromString(puzzles[i]);
+    Portfolio::Result race = portfolio.solve(board);
+    stats.routedToPortfolio++;
+    if (race.solved) {
+      stats.portfolioWins[race.winnerIndex]++;
+      results[i].solution = board.toString();
+      results[i].solved = true;
+    }
+  }
+
+  // 3. The rest, longest-predicted-first across the workers
+  parallelFor(threads, order.size() - first, [&](size_t k) {
+    size_t i = order[first + k];
+    SudokuBoard board;
+    board.loadFromString(puzzles[i]);
+    solveOne(i, board);
+  });
+  stats.recursions = recursions;
+  stats.backtracks = backtracks;
+}
+
+void BatchSolver::solveAdaptive(const std::vector<std::string> &puzzles,
+                                std::vector<Result> &results) {
+  stats.enginePicks.assign(EngineSelector::kEngines, 0);
+  stats.portfolioWins.assign(portfolio.getConfigs().size(), 0);
+  solveEach(puzzles, results, [this](SudokuBoard &board) {
+    // extract() leaves the board at the logic fixpoint; the chosen engine
+    // continues from there.
+    EngineSelector::Engine chosen =
+        selector.choose(EngineSelector::extract(board));
+    stats.enginePicks[static_cast<int>(chosen)]++;
+    EngineSelector::Run run = EngineSelector::solve(board, chosen, portfolio);
+    stats.recursions += run.recursions;
+    stats.backtracks += run.backtracks;
+    if (run.solved && run.portfolioWinner >= 0)
+      stats.portfolioWins[run.portfolioWinner]++;
+    return run.solved;
+  });
+}
+
+void BatchSolver::verifyResults(const std::vector<std::string> &puzzles,
+                                std::vector<Result> &results) {
+  GridVerifier verifier;
+  GridVerifier::GridAt puzzleAt;
+  if (puzzles.size() == results.size())
+    puzzleAt = [&](size_t i) { return std::string_view(puzzles[i]); };
+  std::vector<GridVerifier::Verdict> verdicts = verifier.verify(
+      results.size(),
+      [&](size_t i) { return std::string_view(results[i].solution); },
+      puzzleAt);
+  stats.verifySeconds = verifier.getStats().seconds;
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (!results[i].solved)
+      continue;
+    if (verdicts[i] == GridVerifier::Verdict::VALID) {
+      stats.verified++;
+    } else {
+      stats.rejected++;
+      results[i].solved = false;
+      results[i].solution.clear();
+    }
+  }
+}
@@ -0,0 +1,111 @@
+#include "EngineRace.hpp"
+
+EngineRace::EngineRace() : EngineRace(defaultLanes()) {}
+
+EngineRace::EngineRace(const std::vector<Lane> &lanes) {
+  for (const Lane &lane : lanes) {
+    runners.push_back(std::unique_ptr<Runner>(new Runner()));
+    runners.back()->lane = lane;
+  }
+}
+
+EngineRace::~EngineRace() { cancel(); }
+
+std::vector<EngineRace::Lane> EngineRace::defaultLanes() {
+  return {{"Hybrid (Logic + MRV)", Solver::Mode::HYBRID, 1},
+          {"Pure MRV", Solver::Mode::BACKTRACK_ONLY, 1},
+          {"Random Restarts", Solver::Mode::RANDOM_RESTARTS, 1},
+          {"SAT (CDCL)", Solver::Mode::SAT, 1}};
+}
+
+void EngineRace::start(const SudokuBoard &puzzle) {
+  cancel();
+  cancelFlag = false;
+  finishedCount = 0;
+  startTime = std::chrono::steady_clock::now();
+
+  for (std::unique_ptr<Runner> &slot : runners) {
+    Runner *r = slot.get();
+    r->board = puzzle;
+    r->heatmap.reset();
+    r->finished = false;
+    r->solved = false;
+    r->place = 0;
+    r->finalNodes = 0;
+    r->finalBacktracks = 0;
+    r->finishNs = 0;
+    r->thread = std::thread([this, r]() {
+      Solver solver(r->board);
+      solver.setMode(r->lane.mode);
+      solver.setSeed(r->lane.seed);
+      solver.setHeatmap(&r->heatmap);
+      solver.setCancelFlag(&cancelFlag);
+      bool ok = solver.solve() && r->board.isComplete();
+
+      r->finalNodes = solver.getRecursionCount();
+      r->finalBacktracks = solver.getBacktrackCount();
+      r->finishNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - startTime)
+                        .count();
+      r->solved = ok;
+      if (!cancelFlag)
+        r->place = ++finishedCount;
+      r->finished = true;
+    });
+  }
+}
+
+void EngineRace::cancel() {
+  cancelFlag = true;
+  join();
+}
+
+void EngineRace::wait() { join(); }
+
+void EngineRace::join() {
+  for (std::unique_ptr<Runner> &r : runners) {
+    if (r->thread.joinable())
+      r->thread.join();
+  }
+}
+
+bool EngineRace::isRunning() const {
+  for (const std::unique_ptr<Runner> &r : runners) {
+    if (r->thread.joinable() && !r->finished)
+      return true;
+  }
+  return false;
+}
+
+size_t EngineRace::size() const { return runners.size(); }
+
+const EngineRace::Lane &EngineRace::getLane(size_t lane) const {
+  return runners[lane]->lane;
+}
+
+const SudokuBoard &EngineRace::getBoard(size_t lane) const {
+  return runners[lane]->board;
+}
+
+EngineRace::Status EngineRace::getStatus(size_t lane) const {
+  const Runner &r = *runners[lane];
+  Status s;
+  s.finished = r.finished;
+  if (s.finished) {
+    s.solved = r.solved;
+    s.place = r.place;
+    s.nodes = r.finalNodes;
+    s.backtracks = r.finalBacktracks;
+    s.seconds = r.finishNs * 1e-9;
+  } else if (r.thread.joinable()) {
+    s.nodes = r.heatmap.nodes.load(std::memory_order_relaxed);
+    for (int k = 0; k < 81; ++k)
+      s.backtracks += r.heatmap.backtracks[k].load(std::memory_order_relaxed);
+    s.seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - startTime)
+                    .count();
+  }
+  if (s.seconds > 0.0)
+    s.nodesPerSecond = s.nodes / s.seconds;
+  return s;
+}
@@ -0,0 +1,389 @@
+#include "EngineSelector.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace {
+const char *const kMagic = "SDKCOSTS";
+const int kVersion = 2;
+
+// Bucket = noSolutionSeen * 15 + emptyBand * 5 + treeBand.
+// Upper bounds of the first two bands of cells left after the fixpoint, and
+// of the first four bands of estimated MRV tree size; above the last bound
+// is the top band. Unsolvable puzzles almost always land in the
+// no-solution-seen half, where refuting a large tree is what costs.
+const int kEmptyBands[] = {44, 57};
+const double kTreeBands[] = {1e2, 1e4, 1e6, 1e8};
+
+struct DefaultCost {
+  int bucket;
+  EngineSelector::Engine engine;
+  long long samples;
+  double seconds;
+};
+
+// Measured with `SudokuBatch corpus.txt --calibrate` (best of 3, 1 s limit)
+// on one core over 2804 puzzles: the 2004-puzzle generated mix, 200
+// low-clue grids with one given changed (about half unsolvable) and 600
+// random 17-26 clue subsets of solved grids (many solutions).
+using E = EngineSelector::Engine;
+const DefaultCost kDefaultCosts[] = {
+    {0, E::MRV, 401, 0.0005186},
+    {0, E::RESTARTS, 401, 0.002538},
+    {0, E::SAT, 401, 1.417},
+    {0, E::PORTFOLIO, 401, 1.735},
+    {1, E::MRV, 289, 0.001605},
+    {1, E::RESTARTS, 289, 0.005896},
+    {1, E::SAT, 289, 1.025},
+    {1, E::PORTFOLIO, 289, 1.255},
+    {2, E::MRV, 27, 0.0002243},
+    {2, E::RESTARTS, 27, 0.0007118},
+    {2, E::SAT, 27, 0.09615},
+    {2, E::PORTFOLIO, 27, 0.1178},
+    {6, E::MRV, 181, 0.002644},
+    {6, E::RESTARTS, 181, 0.008014},
+    {6, E::SAT, 181, 0.6495},
+    {6, E::PORTFOLIO, 181, 0.8005},
+    {7, E::MRV, 409, 0.009462},
+    {7, E::RESTARTS, 409, 0.01762},
+    {7, E::SAT, 409, 1.447},
+    {7, E::PORTFOLIO, 409, 1.767},
+    {8, E::MRV, 165, 0.01258},
+    {8, E::RESTARTS, 165, 0.007418},
+    {8, E::SAT, 165, 0.606},
+    {8, E::PORTFOLIO, 165, 0.7356},
+    {9, E::MRV, 4, 5.726e-05},
+    {9, E::RESTARTS, 4, 0.0001562},
+    {9, E::SAT, 4, 0.01571},
+    {9, E::PORTFOLIO, 4, 0.01854},
+    {12, E::MRV, 109, 0.004155},
+    {12, E::RESTARTS, 109, 0.006835},
+    {12, E::SAT, 109, 0.3883},
+    {12, E::PORTFOLIO, 109, 0.4939},
+    {13, E::MRV, 399, 0.03705},
+    {13, E::RESTARTS, 399, 0.02278},
+    {13, E::SAT, 399, 1.41},
+    {13, E::PORTFOLIO, 399, 1.744},
+    {14, E::MRV, 109, 0.003745},
+    {14, E::RESTARTS, 109, 0.00587},
+    {14, E::SAT, 109, 0.3811},
+    {14, E::PORTFOLIO, 109, 0.4656},
+    {15, E::MRV, 17, 9.284e-05},
+    {15, E::RESTARTS, 17, 0.001694},
+    {15, E::SAT, 17, 0.05806},
+    {15, E::PORTFOLIO, 17, 0.07326},
+    {16, E::MRV, 22, 0.001012},
+    {16, E::RESTARTS, 22, 0.004021},
+    {16, E::SAT, 22, 0.07786},
+    {16, E::PORTFOLIO, 22, 0.09496},
+    {17, E::MRV, 1, 0.001173},
+    {17, E::RESTARTS, 1, 0.009053},
+    {17, E::SAT, 1, 0.002353},
+    {17, E::PORTFOLIO, 1, 0.003932},
+    {20, E::MRV, 30, 0.0003062},
+    {20, E::RESTARTS, 30, 0.001633},
+    {20, E::SAT, 30, 0.1039},
+    {20, E::PORTFOLIO, 30, 0.1291},
+    {21, E::MRV, 46, 0.01353},
+    {21, E::RESTARTS, 46, 1.068},
+    {21, E::SAT, 46, 0.1588},
+    {21, E::PORTFOLIO, 46, 0.2134},
+    {22, E::MRV, 9, 0.2786},
+    {22, E::RESTARTS, 9, 3.061},
+    {22, E::SAT, 9, 0.03222},
+    {22, E::PORTFOLIO, 9, 0.08514},
+    {23, E::MRV, 2, 1.436},
+    {23, E::RESTARTS, 2, 1.109},
+    {23, E::SAT, 2, 0.006709},
+    {23, E::PORTFOLIO, 2, 0.03294},
+    {25, E::MRV, 2, 2.214e-05},
+    {25, E::RESTARTS, 2, 6.759e-05},
+    {25, E::SAT, 2, 0.007714},
+    {25, E::PORTFOLIO, 2, 0.00874},
+    {26, E::MRV, 6, 0.005326},
+    {26, E::RESTARTS, 6, 1.001},
+    {26, E::SAT, 6, 0.02173},
+    {26, E::PORTFOLIO, 6, 0.04078},
+    {27, E::MRV, 21, 1.586},
+    {27, E::RESTARTS, 21, 11.13},
+    {27, E::SAT, 21, 0.07014},
+    {27, E::PORTFOLIO, 21, 0.2362},
+    {28, E::MRV, 14, 7.133},
+    {28, E::RESTARTS, 14, 12},
+    {28, E::SAT, 14, 0.04562},
+    {28, E::PORTFOLIO, 14, 0.1908},
+};
+
+int engineIndex(EngineSelector::Engine engine) {
+  return static_cast<int>(engine);
+}
+} // namespace
+
+EngineSelector::EngineSelector() {
+  for (const DefaultCost &d : kDefaultCosts) {
+    Cost &c = table[d.bucket][engineIndex(d.engine)];
+    c.samples = d.samples;
+    c.seconds = d.seconds;
+  }
+}
+
+EngineSelector::Features EngineSelector::extract(SudokuBoard &board) {
+  Features f;
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; ++c)
+      f.clues += board.getValue(r, c) != 0;
+  }
+
+  Solver logic(board);
+  logic.setMode(Solver::Mode::LOGIC_ONLY);
+  logic.solveHumanistic();
+  f.logicPlacements = static_cast<int>(logic.getLogicCount());
+
+  int candidates = 0;
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; ++c) {
+      if (board.getValue(r, c) != 0)
+        continue;
+      int count = 0;
+      for (int m = board.getCandidates(r, c); m; m &= m - 1)
+        count++;
+      f.histogram[count]++;
+      f.emptyAfterLogic++;
+      candidates += count;
+    }
+  }
+  f.contradiction = f.histogram[0] > 0;
+  if (f.emptyAfterLogic > 0)
+    f.meanCandidates = static_cast<double>(candidates) / f.emptyAfterLogic;
+
+  if (f.emptyAfterLogic > 0 && !f.contradiction) {
+    // Plain MRV from the fixpoint, so the probes skip the logic pass
+    Solver probe(board);
+    probe.setMode(Solver::Mode::BACKTRACK_ONLY);
+    Solver::TreeEstimate estimate = probe.estimateSearch();
+    f.treeNodes = estimate.treeNodes;
+    f.solutions = estimate.solutions;
+  }
+  return f;
+}
+
+int EngineSelector::bucketOf(const Features &f) {
+  int emptyBand = 2;
+  for (int b = 0; b < 2; ++b) {
+    if (f.emptyAfterLogic <= kEmptyBands[b]) {
+      emptyBand = b;
+      break;
+    }
+  }
+  int treeBand = 4;
+  for (int b = 0; b < 4; ++b) {
+    if (f.treeNodes < kTreeBands[b]) {
+      treeBand = b;
+      break;
+    }
+  }
+  int noSolutionSeen = f.solutions > 0.0 ? 0 : 1;
+  return noSolutionSeen * 15 + emptyBand * 5 + treeBand;
+}
+
+EngineSelector::Engine EngineSelector::choose(const Features &f) const {
+  if (f.emptyAfterLogic == 0)
+    return Engine::LOGIC;
+
+  const Cost *row = table[bucketOf(f)];
+  Engine best = Engine::MRV;
+  double bestSeconds = -1.0;
+  for (int e = 0; e < kEngines; ++e) {
+    if (e == engineIndex(Engine::LOGIC) || row[e].samples == 0)
+      continue;
+    if (bestSeconds < 0.0 || row[e].mean() < bestSeconds) {
+      best = static_cast<Engine>(e);
+      bestSeconds = row[e].mean();
+    }
+  }
+  return best;
+}
+
+double EngineSelector::predict(const Features &f, Engine engine) const {
+  return table[bucketOf(f)][engineIndex(engine)].mean();
+}
+
+void EngineSelector::record(const Features &f, Engine engine,
+                            double seconds) {
+  Cost &c = table[bucketOf(f)][engineIndex(engine)];
+  c.samples++;
+  c.seconds += seconds;
+}
+
+int EngineSelector::calibrate(const std::vector<std::string> &puzzles,
+                              const std::vector<Engine> &engines,
+                              int repeats, double limitSeconds) {
+  clear();
+  Portfolio portfolio;
+
+  // One watchdog for the whole run: starting a thread per solve would cost
+  // more than many of the solves being timed.
+  using Clock = std::chrono::steady_clock;
+  std::atomic<bool> cancel{false}, stop{false};
+  std::atomic<long long> deadline{0}; // Clock ticks; 0 while idle
+  std::thread watchdog([&]() {
+    while (!stop) {
+      long long d = deadline;
+      if (d != 0 && Clock::now().time_since_epoch().count() > d)
+        cancel = true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  });
+  auto limit = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(limitSeconds));
+
+  int measured = 0;
+  for (const std::string &text : puzzles) {
+    SudokuBoard start;
+    if (!start.loadFromString(text))
+      continue;
+    Features f = extract(start);
+    if (f.emptyAfterLogic == 0 || f.contradiction)
+      continue;
+
+    for (Engine engine : engines) {
+      if (engine == Engine::LOGIC)
+        continue;
+      double best = -1.0;
+      for (int k = 0; k < repeats; ++k) {
+        SudokuBoard board = start;
+        cancel = false;
+        auto t0 = Clock::now();
+        deadline = (t0 + limit).time_since_epoch().count();
+        solve(board, engine, portfolio, &cancel);
+        deadline = 0;
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (cancel)
+          s = limitSeconds;
+        if (best < 0.0 || s < best)
+          best = s;
+        if (cancel)
+          break; // Repeating a run that hit the limit only costs time
+      }
+      record(f, engine, best);
+    }
+    measured++;
+  }
+  stop = true;
+  watchdog.join();
+  return measured;
+}
+
+EngineSelector::Run EngineSelector::solve(SudokuBoard &board, Engine engine,
+                                          Portfolio &portfolio,
+                                          const std::atomic<bool> *cancel) {
+  Run run;
+  if (engine == Engine::PORTFOLIO) {
+    Portfolio::Result race = portfolio.solve(board);
+    run.solved = race.solved;
+    run.portfolioWinner = race.winnerIndex;
+    return run;
+  }
+  Solver solver(board);
+  solver.setMode(solverMode(engine));
+  solver.setSeed(1);
+  solver.setCancelFlag(cancel);
+  run.solved = solver.solve() && board.isComplete();
+  run.recursions = solver.getRecursionCount();
+  run.backtracks = solver.getBacktrackCount();
+  return run;
+}
+
+void EngineSelector::clear() {
+  for (auto &row : table) {
+    for (Cost &c : row)
+      c = Cost();
+  }
+}
+
+const EngineSelector::Cost &EngineSelector::getCost(int bucket,
+                                                    Engine engine) const {
+  return table[bucket][engineIndex(engine)];
+}
+
+bool EngineSelector::save(const std::string &path) const {
+  std::string temp = path + ".tmp";
+  {
+    std::ofstream out(temp, std::ios::trunc);
+    if (!out)
+      return false;
+    out << kMagic << " " << kVersion << "\n";
+    out.precision(17);
+    for (int b = 0; b < kBuckets; ++b) {
+      for (int e = 0; e < kEngines; ++e) {
+        if (table[b][e].samples > 0)
+          out << b << " " << e << " " << table[b][e].samples << " "
+              << table[b][e].seconds << "\n";
+      }
+    }
+    if (!out.flush())
+      return false;
+  }
+  return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+bool EngineSelector::load(const std::string &path) {
+  std::ifstream in(path);
+  std::string magic;
+  int version = 0;
+  if (!(in >> magic >> version) || magic != kMagic || version != kVersion)
+    return false;
+
+  Cost loaded[kBuckets][kEngines];
+  int b, e;
+  long long samples;
+  double seconds;
+  while (in >> b >> e >> samples >> seconds) {
+    if (b < 0 || b >= kBuckets || e < 0 || e >= kEngines || samples < 0 ||
+        seconds < 0.0)
+      return false;
+    loaded[b][e].samples = samples;
+    loaded[b][e].seconds = seconds;
+  }
+  if (!in.eof())
+    return false;
+
+  for (int i = 0; i < kBuckets; ++i) {
+    for (int j = 0; j < kEngines; ++j)
+      table[i][j] = loaded[i][j];
+  }
+  return true;
+}
+
+std::string EngineSelector::engineName(Engine engine) {
+  switch (engine) {
+  case Engine::LOGIC:
+    return "logic";
+  case Engine::MRV:
+    return "mrv";
+  case Engine::RESTARTS:
+    return "restarts";
+  case Engine::SAT:
+    return "sat";
+  case Engine::PORTFOLIO:
+    return "portfolio";
+  }
+  return "mrv";
+}
+
+Solver::Mode EngineSelector::solverMode(Engine engine) {
+  switch (engine) {
+  case Engine::LOGIC:
+    return Solver::Mode::LOGIC_ONLY;
+  case Engine::MRV:
+    return Solver::Mode::BACKTRACK_ONLY;
+  case Engine::RESTARTS:
+    return Solver::Mode::RANDOM_RESTARTS;
+  case Engine::SAT:
+    return Solver::Mode::SAT;
+  case Engine::PORTFOLIO:
+    return Solver::Mode::HYBRID;
+  }
+  return Solver::Mode::HYBRID;
+}
@@ -1,55 +1,50 @@
 #include "Generator.hpp"
+#include "SudokuTables.hpp"
+#include "TranspositionTable.hpp"
 #include <algorithm>
-#include <iostream>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <mutex>
 #include <random>
+#include <thread>
 #include <vector>
 
 
 Generator::Generator() {}
 
 void Generator::generate(SudokuBoard &board, Difficulty level) {
-  // 1. Clear the board
-  // We need a way to clear the board, assuming loadBoard with empty grid works
-  // or simple reset. SudokuBoard doesn't have a public clear/reset exposed
-  // directly other than loadBoard, but we can create an empty grid.
-  std::vector<std::vector<int>> emptyGrid(9, std::vector<int>(9, 0));
-  board.loadBoard(emptyGrid);
-
-  // 2. Fill Diagonal Boxes (independent of each other)
-  fillDiagonal(board);
-
-  // 3. Solve the rest randomly
-  Solver solver(board);
-  // Suppress callbacks during generation if any were set?
-  // Solver internal state is fresh.
-  bool success = solver.solveRandomized();
-
-  if (!success) {
-    std::cerr << "Error: Failed to generate a valid board base!" << std::endl;
-    return;
-  }
+  // 1. Draw a complete grid
+  sampler.sample(board);
 
   // At this point, board is fully filled and valid.
-  // 4. Remove Digits
-  int k = 0;
-  switch (level) {
-  case Difficulty::EASY:
-    k = 30;
-    break; // Remove 30 -> 51 clues (Very Easy)
-  case Difficulty::MEDIUM:
-    k = 45;
-    break; // Remove 45 -> 36 clues
-  case Difficulty::HARD:
-    k = 54;
-    break; // Remove 54 -> 27 clues
-  case Difficulty::EXPERT:
-    k = 60;
-    break; // Remove 60 -> 21 clues
-  default:
-    k = 40;
-  }
+  // 2. Remove Digits
+  if (level == Difficulty::MINIMAL) {
+    std::random_device rd;
+    std::mt19937 g(rd());
+    TranspositionTable table(1 << 16);
+    lastCheckNodes = removeToMinimal(board, g, table);
+  } else {
+    int k = 0;
+    switch (level) {
+    case Difficulty::EASY:
+      k = 30;
+      break; // Remove 30 -> 51 clues (Very Easy)
+    case Difficulty::MEDIUM:
+      k = 45;
+      break; // Remove 45 -> 36 clues
+    case Difficulty::HARD:
+      k = 54;
+      break; // Remove 54 -> 27 clues
+    case Difficulty::EXPERT:
+      k = 60;
+      break; // Remove 60 -> 21 clues
+    default:
+      k = 40;
+    }
 
-  removeDigits(board, k);
+    removeDigits(board, k);
+  }
 
   // Now re-load the board into itself to fix the remaining cells?
   // Or does removeDigits just set them to 0?
@@ -69,39 +64,14 @@ void Generator::generate(SudokuBoard &board, Difficulty level) {
   board.loadBoard(queryGrid);
 }
 
-void Generator::fillDiagonal(SudokuBoard &board) {
-  for (int i = 0; i < 9; i = i + 3) {
-    fillBox(board, i, i);
-  }
-}
-
-void Generator::fillBox(SudokuBoard &board, int row, int col) {
-  int num;
-  std::random_device rd;
-  std::mt19937 g(rd());
-
-  // We simply need to fill the 3x3 box with 1-9 randomly.
-  // Since it's diagonal, no row/col conflicts exist yet with other diagonal
-  // boxes.
-  std::vector<int> nums = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-  std::shuffle(nums.begin(), nums.end(), g);
-
-  int idx = 0;
-  for (int i = 0; i < 3; i++) {
-    for (int j = 0; j < 3; j++) {
-      board.placeNumber(row + i, col + j, nums[idx++]);
-    }
-  }
-}
-
 void Generator::removeDigits(SudokuBoard &board, int count) {
   std::random_device rd;
   std::mt19937 g(rd());
 
   while (count > 0) {
     int cellId = std::uniform_int_distribution<>(0, 80)(g);
-    int i = cellId / 9;
-    int j = cellId % 9;
+    int i = kSudokuTables.rowOf[cellId];
+    int j = kSudokuTables.colOf[cellId];
 
     if (board.getValue(i, j) != 0) {
       // Check if removing this cell leaves a unique solution?
@@ -116,3 +86,182 @@ void Generator::removeDigits(SudokuBoard &board, int count) {
     }
   }
 }
+
+// Tries every cell once in random order. The puzzle before a removal has a
+// single solution (the filled board), so after clearing a cell any second
+// solution must put a different digit there: the check only searches with
+// each alternative digit forced into that cell, never re-deriving the known
+// solution. Dead positions depend only on the digits on the board, so one
+// transposition table stays valid across all checks and later searches
+// reuse what earlier ones refuted.
+long long Generator::removeToMinimal(SudokuBoard &board, std::mt19937 &rng,
+                                     TranspositionTable &table) {
+  std::vector<int> order(81);
+  for (int i = 0; i < 81; ++i)
+    order[i] = i;
+  std::shuffle(order.begin(), order.end(), rng);
+
+  Solver checker(board);
+  checker.setTranspositionTable(&table);
+  long long checkNodes = 0;
+
+  for (int cellId : order) {
+    int i = kSudokuTables.rowOf[cellId];
+    int j = kSudokuTables.colOf[cellId];
+    int solutionValue = board.getValue(i, j);
+    if (solutionValue == 0)
+      continue;
+    board.removeNumber(i, j);
+
+    bool unique = true;
+    for (int num = 1; num <= 9 && unique; ++num) {
+      if (num == solutionValue || !board.isValid(i, j, num))
+        continue;
+      board.placeNumber(i, j, num);
+      unique = checker.countSolutions(1) == 0;
+      checkNodes += checker.getRecursionCount();
+      board.removeNumber(i, j);
+    }
+
+    if (!unique)
+      board.placeNumber(i, j, solutionValue); // Clue is needed; keep it
+  }
+  return checkNodes;
+}
+
+long long Generator::getLastCheckNodes() const { return lastCheckNodes; }
+
+bool Generator::parsePattern(const std::string &text, std::bitset<81> &mask) {
+  std::bitset<81> parsed;
+  int cell = 0;
+  for (char ch : text) {
+    if (std::isspace(static_cast<unsigned char>(ch)))
+      continue;
+    if (cell == 81)
+      return false;
+    parsed[cell++] = !(ch == '.' || ch == '0' || ch == '-');
+  }
+  if (cell != 81)
+    return false;
+  mask = parsed;
+  return true;
+}
+
+namespace {
+// Single-given changes tried per starting grid before giving up on it.
+constexpr int kStepsPerAttempt = 400;
+
+// Solution counts are capped here; beyond it a candidate is "very open".
+constexpr long long kCountCap = 64;
+} // namespace
+
+Generator::PatternResult
+Generator::generateWithPattern(SudokuBoard &board, const std::bitset<81> &mask,
+                               const PatternOptions &options) {
+  PatternResult result;
+  auto start = std::chrono::steady_clock::now();
+  if (mask.count() < 17)
+    return result; // No 16-clue Sudoku has a unique solution
+
+  std::vector<int> maskCells;
+  for (int cell = 0; cell < 81; ++cell) {
+    if (mask[cell])
+      maskCells.push_back(cell);
+  }
+
+  int threads = options.threads > 0
+                    ? options.threads
+                    : static_cast<int>(std::thread::hardware_concurrency());
+  threads = std::max(threads, 1);
+  unsigned int baseSeed = options.seed;
+  if (baseSeed == 0) {
+    std::random_device rd;
+    baseSeed = rd();
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<long long> attempts{0};
+  std::mutex winnerMutex;
+  std::vector<std::vector<int>> winner;
+
+  auto worker = [&](int index) {
+    std::mt19937 g(baseSeed + static_cast<unsigned int>(index) * 0x9E3779B9u);
+    // The member sampler is not shared across threads; each worker draws its
+    // starting grids from its own, seeded from the pattern seed.
+    GridSampler grids((static_cast<uint64_t>(g()) << 32) | g() | 1);
+    TranspositionTable table(1 << 16); // Counts stay valid across attempts
+
+    while (!done && attempts++ < options.maxAttempts) {
+      SudokuBoard full;
+      grids.sample(full);
+
+      SudokuBoard puzzle;
+      for (int cell : maskCells) {
+        int row = kSudokuTables.rowOf[cell];
+        int col = kSudokuTables.colOf[cell];
+        puzzle.placeNumber(row, col, full.getValue(row, col));
+      }
+      Solver counter(puzzle);
+      counter.setTranspositionTable(&table);
+      counter.setCancelFlag(&done);
+      long long count = counter.countSolutions(kCountCap);
+
+      for (int step = 0; step < kStepsPerAttempt && count > 1 && !done;
+           ++step) {
+        int cell = maskCells[g() % maskCells.size()];
+        int row = kSudokuTables.rowOf[cell];
+        int col = kSudokuTables.colOf[cell];
+        int old = puzzle.getValue(row, col);
+        int num = 1 + static_cast<int>(g() % 8);
+        num += num >= old; // Any digit but the current one
+
+        puzzle.removeNumber(row, col);
+        long long next = 0;
+        if (puzzle.isValid(row, col, num)) {
+          puzzle.placeNumber(row, col, num);
+          next = counter.countSolutions(kCountCap);
+        }
+        if (next >= 1 && next <= count) {
+          count = next;
+        } else {
+          puzzle.placeNumber(row, col, old);
+        }
+      }
+
+      if (count == 1 && !done) {
+        bool expected = false;
+        if (done.compare_exchange_strong(expected, true)) {
+          std::lock_guard<std::mutex> lock(winnerMutex);
+          winner.assign(9, std::vector<int>(9));
+          for (int r = 0; r < 9; ++r) {
+            for (int c = 0; c < 9; ++c)
+              winner[r][c] = puzzle.getValue(r, c);
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threads; ++t)
+    workers.emplace_back(worker, t);
+  worker(0);
+  for (std::thread &t : workers)
+    t.join();
+
+  if (!winner.empty()) {
+    board.loadBoard(winner);
+    result.found = true;
+  }
+  result.attempts = std::min(attempts.load(), options.maxAttempts);
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+Generator::PatternResult
+Generator::generateWithPattern(SudokuBoard &board,
+                               const std::bitset<81> &mask) {
+  return generateWithPattern(board, mask, PatternOptions());
+}
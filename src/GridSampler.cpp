@@ -0,0 +1,117 @@
+#include "GridSampler.hpp"
+#include "Solver.hpp"
+#include <array>
+#include <random>
+
+namespace {
+using Grid = std::array<uint8_t, 81>;
+
+uint64_t splitMix64(uint64_t &x) {
+  uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+// Solved once, with fixed seeds so a given sampler seed always yields the
+// same grids.
+const std::array<Grid, GridSampler::kBaseGrids> &baseGrids() {
+  static const std::array<Grid, GridSampler::kBaseGrids> table = [] {
+    std::array<Grid, GridSampler::kBaseGrids> grids;
+    for (int i = 0; i < GridSampler::kBaseGrids; ++i) {
+      SudokuBoard board;
+      Solver solver(board);
+      solver.setSeed(static_cast<unsigned int>(i + 1));
+      solver.solveRandomized();
+      for (int cell = 0; cell < 81; ++cell)
+        grids[i][cell] =
+            static_cast<uint8_t>(board.getValue(cell / 9, cell % 9));
+    }
+    return grids;
+  }();
+  return table;
+}
+} // namespace
+
+GridSampler::GridSampler(uint64_t seed) { reseed(seed); }
+
+void GridSampler::reseed(uint64_t seed) {
+  if (seed == 0) {
+    std::random_device rd;
+    seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+  }
+  for (uint64_t &word : state)
+    word = splitMix64(seed);
+}
+
+uint64_t GridSampler::next() {
+  uint64_t result = rotl(state[1] * 5, 7) * 9;
+  uint64_t t = state[1] << 17;
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotl(state[3], 45);
+  return result;
+}
+
+int GridSampler::below(int n) {
+  // Multiply-shift; the bias for n <= 9 is far below 2^-28
+  return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(n)) >> 32);
+}
+
+void GridSampler::shuffle(uint8_t *items, int count) {
+  for (int i = count - 1; i > 0; --i) {
+    int j = below(i + 1);
+    uint8_t tmp = items[i];
+    items[i] = items[j];
+    items[j] = tmp;
+  }
+}
+
+void GridSampler::sample(uint8_t grid[81]) {
+  const uint8_t *base = baseGrids()[below(kBaseGrids)].data();
+
+  uint8_t digits[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  shuffle(digits + 1, 9);
+
+  // Source row / column for each target line: bands (stacks) are shuffled as
+  // blocks, then the three lines inside each block.
+  uint8_t lines[2][9];
+  for (uint8_t *order : lines) {
+    uint8_t blocks[3] = {0, 1, 2};
+    shuffle(blocks, 3);
+    for (int b = 0; b < 3; ++b) {
+      uint8_t inner[3] = {0, 1, 2};
+      shuffle(inner, 3);
+      for (int k = 0; k < 3; ++k)
+        order[b * 3 + k] = static_cast<uint8_t>(blocks[b] * 3 + inner[k]);
+    }
+  }
+  const uint8_t *rows = lines[0];
+  const uint8_t *cols = lines[1];
+
+  if (next() & 1) {
+    for (int r = 0; r < 9; ++r) {
+      for (int c = 0; c < 9; ++c)
+        grid[r * 9 + c] = digits[base[cols[c] * 9 + rows[r]]];
+    }
+  } else {
+    for (int r = 0; r < 9; ++r) {
+      const uint8_t *src = base + rows[r] * 9;
+      for (int c = 0; c < 9; ++c)
+        grid[r * 9 + c] = digits[src[cols[c]]];
+    }
+  }
+}
+
+void GridSampler::sample(SudokuBoard &board) {
+  uint8_t grid[81];
+  sample(grid);
+  board = SudokuBoard();
+  for (int cell = 0; cell < 81; ++cell)
+    board.placeNumber(cell / 9, cell % 9, grid[cell]);
+}
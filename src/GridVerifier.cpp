@@ -0,0 +1,164 @@
+#include "GridVerifier.hpp"
+#include "SudokuTables.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+const uint16_t kAllDigits = 0x3FE; // bits 1-9
+
+// Stands in for a grid of the wrong length: no digits, no givens.
+const std::string kBlankRecord(81, '0');
+
+// One-hot digit bit, 0 for anything but '1'-'9'; the range check is a mask
+// rather than a branch so the transpose loops vectorize.
+uint16_t digitBit(char ch) {
+  unsigned n = static_cast<unsigned char>(ch) - static_cast<unsigned>('0');
+  unsigned inRange = 0u - static_cast<unsigned>(n - 1u < 9u);
+  return static_cast<uint16_t>((1u << (n & 15u)) & inRange);
+}
+
+const char *record(std::string_view grid) {
+  return grid.size() == 81 ? grid.data() : kBlankRecord.data();
+}
+} // namespace
+
+const GridVerifier::Stats &GridVerifier::getStats() const { return stats; }
+
+std::vector<GridVerifier::Verdict>
+GridVerifier::verify(const std::vector<std::string> &solutions) {
+  return verify(solutions.size(),
+                [&](size_t i) { return std::string_view(solutions[i]); });
+}
+
+std::vector<GridVerifier::Verdict>
+GridVerifier::verify(const std::vector<std::string> &solutions,
+                     const std::vector<std::string> &puzzles) {
+  if (puzzles.size() != solutions.size())
+    return verify(solutions);
+  return verify(
+      solutions.size(),
+      [&](size_t i) { return std::string_view(solutions[i]); },
+      [&](size_t i) { return std::string_view(puzzles[i]); });
+}
+
+std::vector<GridVerifier::Verdict>
+GridVerifier::verify(const char *solutions, size_t count,
+                     const char *puzzles) {
+  GridAt puzzleAt;
+  if (puzzles)
+    puzzleAt = [=](size_t i) { return std::string_view(puzzles + i * 81, 81); };
+  return verify(
+      count,
+      [=](size_t i) { return std::string_view(solutions + i * 81, 81); },
+      puzzleAt);
+}
+
+std::vector<GridVerifier::Verdict>
+GridVerifier::verify(size_t count, const GridAt &solutionAt,
+                     const GridAt &puzzleAt) {
+  stats = Stats();
+  std::vector<Verdict> verdicts(count, Verdict::VALID);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t first = 0; first < count; first += kLanes) {
+    int lanes = static_cast<int>(std::min<size_t>(kLanes, count - first));
+    verifyBlock(solutionAt, puzzleAt, first, lanes, verdicts);
+  }
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+  for (Verdict v : verdicts) {
+    stats.checked++;
+    if (v == Verdict::VALID)
+      stats.valid++;
+    else if (v == Verdict::MALFORMED)
+      stats.malformed++;
+    else if (v == Verdict::BROKEN_UNIT)
+      stats.brokenUnit++;
+    else
+      stats.givenChanged++;
+  }
+  return verdicts;
+}
+
+void GridVerifier::verifyBlock(const GridAt &solutionAt,
+                               const GridAt &puzzleAt, size_t first,
+                               int count, std::vector<Verdict> &verdicts) {
+  // One 81-byte record per lane; unused lanes repeat lane 0 so the lane
+  // loops need no tail handling, and a malformed length reads as blank.
+  const char *solution[kLanes];
+  const char *puzzle[kLanes];
+  for (int l = 0; l < kLanes; ++l) {
+    size_t index = first + (l < count ? l : 0);
+    solution[l] = record(solutionAt(index));
+    puzzle[l] = puzzleAt ? record(puzzleAt(index)) : kBlankRecord.data();
+  }
+
+  // Transpose into lanes
+  for (int c = 0; c < 81; ++c) {
+    for (int l = 0; l < kLanes; ++l) {
+      digits[c][l] = digitBit(solution[l][c]);
+      givens[c][l] = digitBit(puzzle[l][c]);
+    }
+  }
+
+  uint16_t badCell[kLanes] = {0};
+  uint16_t changed[kLanes] = {0};
+  for (int c = 0; c < 81; ++c) {
+    for (int l = 0; l < kLanes; ++l) {
+      badCell[l] |= digits[c][l] == 0;
+      changed[l] |= (givens[c][l] != 0) & (givens[c][l] != digits[c][l]);
+    }
+  }
+
+  // Nine one-hot cells cover all nine digits only if no digit repeats
+  uint16_t brokenUnit[kLanes] = {0};
+  for (int u = 0; u < 27; ++u) {
+    uint16_t seen[kLanes] = {0};
+    for (int k = 0; k < 9; ++k) {
+      const uint16_t *cell = digits[kSudokuTables.unitCells[u][k]];
+      for (int l = 0; l < kLanes; ++l)
+        seen[l] |= cell[l];
+    }
+    for (int l = 0; l < kLanes; ++l)
+      brokenUnit[l] |= seen[l] != kAllDigits;
+  }
+
+  for (int l = 0; l < count; ++l) {
+    Verdict &v = verdicts[first + l];
+    if (badCell[l])
+      v = Verdict::MALFORMED;
+    else if (brokenUnit[l])
+      v = Verdict::BROKEN_UNIT;
+    else if (changed[l])
+      v = Verdict::GIVEN_CHANGED;
+    else
+      v = Verdict::VALID;
+  }
+}
+
+GridVerifier::Verdict GridVerifier::verifyOne(const std::string &solution,
+                                              const std::string *puzzle) {
+  if (solution.size() != 81)
+    return Verdict::MALFORMED;
+  uint16_t seen[27] = {0};
+  uint16_t collisions = 0;
+  bool changed = false;
+  for (int c = 0; c < 81; ++c) {
+    uint16_t bit = digitBit(solution[c]);
+    if (bit == 0)
+      return Verdict::MALFORMED;
+    for (int u : kSudokuTables.unitsOf[c]) {
+      collisions |= seen[u] & bit;
+      seen[u] |= bit;
+    }
+    if (puzzle && puzzle->size() == 81) {
+      uint16_t given = digitBit((*puzzle)[c]);
+      changed = changed || (given != 0 && given != bit);
+    }
+  }
+  if (collisions)
+    return Verdict::BROKEN_UNIT;
+  return changed ? Verdict::GIVEN_CHANGED : Verdict::VALID;
+}
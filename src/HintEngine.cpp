@@ -0,0 +1,306 @@
+#include "HintEngine.hpp"
+#include "Solver.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+int countBits(uint16_t mask) {
+  int count = 0;
+  while (mask) {
+    mask &= static_cast<uint16_t>(mask - 1);
+    count++;
+  }
+  return count;
+}
+
+int lowestDigit(uint16_t mask) {
+  for (int n = 1; n <= 9; ++n) {
+    if (mask & (1 << n))
+      return n;
+  }
+  return 0;
+}
+
+std::string cellName(int row, int col) {
+  return "r" + std::to_string(row + 1) + "c" + std::to_string(col + 1);
+}
+} // namespace
+
+HintEngine::~HintEngine() { stopJob(); }
+
+void HintEngine::load(const SudokuBoard &board) {
+  stopJob();
+  position = board;
+
+  std::vector<std::vector<int>> fixedGrid(9, std::vector<int>(9, 0));
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; ++c) {
+      if (board.isFixed(r, c))
+        fixedGrid[r][c] = board.getValue(r, c);
+    }
+  }
+  givens.loadBoard(fixedGrid);
+
+  for (int cell = 0; cell < 81; ++cell)
+    refreshCell(cell / 9, cell % 9);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    haveSolution = false;
+    countPending = true;
+    givenSolutions = -1;
+  }
+  startJob();
+}
+
+HintEngine::Verdict HintEngine::place(int row, int col, int value) {
+  position.placeNumber(row, col, value);
+  refreshCandidates(row, col);
+
+  bool restart;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    // The stored solution no longer fits, or an in-flight solve is looking
+    // at a stale position.
+    restart = haveSolution ? solution[row * 9 + col] != value &&
+                                 givenSolutions != 1
+                           : running;
+  }
+  if (restart)
+    startJob();
+  return getVerdict();
+}
+
+void HintEngine::clear(int row, int col) {
+  position.removeNumber(row, col);
+  refreshCandidates(row, col);
+
+  // Removing a digit keeps a fitting solution valid; otherwise the looser
+  // position may have become solvable again.
+  bool restart;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    restart = !haveSolution;
+  }
+  if (restart)
+    startJob();
+}
+
+HintEngine::Verdict HintEngine::getVerdict() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return verdictLocked();
+}
+
+HintEngine::Verdict HintEngine::verdictLocked() const {
+  if (haveSolution) {
+    if (!hasMismatchLocked())
+      return Verdict::SOLVABLE;
+    return givenSolutions == 1 ? Verdict::WRONG : Verdict::CHECKING;
+  }
+  if (running)
+    return Verdict::CHECKING;
+  return givenSolutions == 0 ? Verdict::NO_SOLUTION : Verdict::WRONG;
+}
+
+bool HintEngine::hasMismatchLocked() const {
+  for (int cell = 0; cell < 81; ++cell) {
+    int v = position.getValue(cell / 9, cell % 9);
+    if (v != 0 && v != solution[cell])
+      return true;
+  }
+  return false;
+}
+
+HintEngine::Hint HintEngine::nextHint() {
+  Hint hint;
+  bool solved;
+  uint8_t known[81];
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    solved = haveSolution;
+    std::copy(solution, solution + 81, known);
+
+    if (!haveSolution && !running) {
+      hint.text = givenSolutions == 0 ? "Puzzle has no solution"
+                                      : "No solution from here, clear a digit";
+      return hint;
+    }
+
+    if (haveSolution && givenSolutions == 1) {
+      for (int cell = 0; cell < 81; ++cell) {
+        int v = position.getValue(cell / 9, cell % 9);
+        if (v != 0 && v != known[cell]) {
+          hint.found = true;
+          hint.row = cell / 9;
+          hint.col = cell % 9;
+          hint.value = known[cell];
+          hint.text = "Wrong digit at " + cellName(hint.row, hint.col);
+          return hint;
+        }
+      }
+    }
+  }
+
+  // Naked singles (and dead cells, which trump everything else)
+  int fewest = -1;
+  for (int cell = 0; cell < 81; ++cell) {
+    int r = cell / 9, c = cell % 9;
+    if (position.getValue(r, c) != 0)
+      continue;
+    int count = countBits(candidates[cell]);
+    if (count == 0) {
+      hint.found = true;
+      hint.row = r;
+      hint.col = c;
+      hint.text = "No candidates left at " + cellName(r, c);
+      return hint;
+    }
+    if (count == 1 && !hint.found) {
+      hint.found = true;
+      hint.row = r;
+      hint.col = c;
+      hint.value = lowestDigit(candidates[cell]);
+      hint.technique = TraceTechnique::NAKED_SINGLE;
+    }
+    if (fewest < 0 || count < countBits(candidates[fewest]))
+      fewest = cell;
+  }
+  if (fewest < 0) {
+    hint.text = "Board is full";
+    return hint;
+  }
+
+  // Hidden singles: unit 0-8 rows, 9-17 columns, 18-26 boxes
+  for (int u = 0; u < 27 && !hint.found; ++u) {
+    int counts[10] = {0};
+    int lastCell[10] = {0};
+    for (int k = 0; k < 9; ++k) {
+      int r, c;
+      if (u < 9) {
+        r = u;
+        c = k;
+      } else if (u < 18) {
+        r = k;
+        c = u - 9;
+      } else {
+        r = ((u - 18) / 3) * 3 + k / 3;
+        c = ((u - 18) % 3) * 3 + k % 3;
+      }
+      uint16_t mask = candidates[r * 9 + c];
+      for (int n = 1; n <= 9; ++n) {
+        if (mask & (1 << n)) {
+          counts[n]++;
+          lastCell[n] = r * 9 + c;
+        }
+      }
+    }
+    for (int n = 1; n <= 9; ++n) {
+      if (counts[n] == 1) {
+        hint.found = true;
+        hint.row = lastCell[n] / 9;
+        hint.col = lastCell[n] % 9;
+        hint.value = n;
+        hint.technique = u < 9    ? TraceTechnique::HIDDEN_SINGLE_ROW
+                         : u < 18 ? TraceTechnique::HIDDEN_SINGLE_COL
+                                  : TraceTechnique::HIDDEN_SINGLE_BOX;
+        break;
+      }
+    }
+  }
+
+  // No single available: reveal the tightest cell from the solution
+  if (!hint.found && solved) {
+    hint.found = true;
+    hint.row = fewest / 9;
+    hint.col = fewest % 9;
+    hint.value = known[fewest];
+    hint.technique = TraceTechnique::GUESS;
+  }
+
+  if (!hint.found)
+    hint.text = "No hint yet, still checking";
+  else
+    hint.text = techniqueToString(hint.technique) + ": " +
+                std::to_string(hint.value) + " at " +
+                cellName(hint.row, hint.col);
+  return hint;
+}
+
+uint16_t HintEngine::getCandidates(int row, int col) const {
+  return candidates[row * 9 + col];
+}
+
+void HintEngine::wait() {
+  if (worker.joinable())
+    worker.join();
+}
+
+void HintEngine::startJob() {
+  stopJob();
+
+  bool count;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = true;
+    haveSolution = false;
+    count = countPending;
+  }
+
+  SudokuBoard snapshot = position;
+  SudokuBoard puzzle = givens;
+  worker = std::thread([this, snapshot, puzzle, count]() mutable {
+    Solver solver(snapshot);
+    solver.setMode(Solver::Mode::HYBRID);
+    solver.setCancelFlag(&cancel);
+    bool solved = solver.solve() && snapshot.isComplete();
+    if (!cancel) {
+      std::lock_guard<std::mutex> lock(mutex);
+      haveSolution = solved;
+      for (int cell = 0; solved && cell < 81; ++cell)
+        solution[cell] =
+            static_cast<uint8_t>(snapshot.getValue(cell / 9, cell % 9));
+    }
+
+    if (count && !cancel) {
+      Solver counter(puzzle);
+      counter.setCancelFlag(&cancel);
+      long long n = counter.countSolutions(2);
+      if (!cancel) {
+        std::lock_guard<std::mutex> lock(mutex);
+        givenSolutions = static_cast<int>(n);
+        countPending = false;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+  });
+}
+
+void HintEngine::stopJob() {
+  if (worker.joinable()) {
+    cancel = true;
+    worker.join();
+  }
+  cancel = false;
+}
+
+void HintEngine::refreshCell(int row, int col) {
+  uint16_t mask = 0;
+  if (position.getValue(row, col) == 0) {
+    for (int n = 1; n <= 9; ++n) {
+      if (position.isValid(row, col, n))
+        mask |= static_cast<uint16_t>(1 << n);
+    }
+  }
+  candidates[row * 9 + col] = mask;
+}
+
+void HintEngine::refreshCandidates(int row, int col) {
+  int boxRow = (row / 3) * 3, boxCol = (col / 3) * 3;
+  for (int k = 0; k < 9; ++k) {
+    refreshCell(row, k);
+    refreshCell(k, col);
+    refreshCell(boxRow + k / 3, boxCol + k % 3);
+  }
+}
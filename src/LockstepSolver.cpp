@@ -0,0 +1,212 @@
+#include "LockstepSolver.hpp"
+#include "Solver.hpp"
+#include "SudokuBoard.hpp"
+#include "SudokuTables.hpp"
+#include <algorithm>
+
+namespace {
+const uint16_t kAllDigits = 0x3FE; // bits 1-9
+} // namespace
+
+LockstepSolver::LockstepSolver() { clearLanes(); }
+
+const LockstepSolver::Stats &LockstepSolver::getStats() const { return stats; }
+
+void LockstepSolver::clearLanes() {
+  std::fill(&cand[0][0], &cand[0][0] + 81 * kLanes, 0);
+  std::fill(&value[0][0], &value[0][0] + 81 * kLanes, 0);
+  std::fill(lanePuzzle, lanePuzzle + kLanes, -1);
+}
+
+void LockstepSolver::loadLane(int lane, const std::string &puzzle, int index) {
+  for (int c = 0; c < 81; ++c) {
+    char ch = c < static_cast<int>(puzzle.size()) ? puzzle[c] : '0';
+    if (ch >= '1' && ch <= '9') {
+      value[c][lane] = static_cast<uint16_t>(1 << (ch - '0'));
+      cand[c][lane] = value[c][lane];
+    } else {
+      value[c][lane] = 0;
+      cand[c][lane] = kAllDigits;
+    }
+  }
+  lanePuzzle[lane] = index;
+}
+
+void LockstepSolver::propagateRound(uint16_t changed[kLanes],
+                                    uint16_t bad[kLanes]) {
+  alignas(64) uint16_t placed[27][kLanes];
+
+  // 1. Digits placed in each unit. A digit seen twice is a contradiction.
+  for (int u = 0; u < 27; ++u) {
+    uint16_t once[kLanes] = {0};
+    uint16_t twice[kLanes] = {0};
+    for (int k = 0; k < 9; ++k) {
+      const uint16_t *v = value[kSudokuTables.unitCells[u][k]];
+      for (int l = 0; l < kLanes; ++l) {
+        twice[l] |= once[l] & v[l];
+        once[l] |= v[l];
+      }
+    }
+    for (int l = 0; l < kLanes; ++l) {
+      placed[u][l] = once[l];
+      bad[l] |= twice[l];
+    }
+  }
+
+  // 2. Candidate elimination and naked singles.
+  for (int c = 0; c < 81; ++c) {
+    const uint16_t *pr = placed[kSudokuTables.unitsOf[c][0]];
+    const uint16_t *pc = placed[kSudokuTables.unitsOf[c][1]];
+    const uint16_t *pb = placed[kSudokuTables.unitsOf[c][2]];
+    uint16_t *cd = cand[c];
+    uint16_t *v = value[c];
+    for (int l = 0; l < kLanes; ++l) {
+      uint16_t m = cd[l] & static_cast<uint16_t>(~(pr[l] | pc[l] | pb[l]));
+      m = v[l] ? v[l] : m;
+      uint16_t single =
+          (v[l] == 0 && (m & (m - 1)) == 0) ? m : static_cast<uint16_t>(0);
+      bad[l] |= (v[l] == 0 && m == 0) ? 1 : 0;
+      cd[l] = m;
+      v[l] |= single;
+      changed[l] |= single;
+    }
+  }
+
+  // 3. Hidden singles: a digit with exactly one open spot in a unit.
+  for (int u = 0; u < 27; ++u) {
+    uint16_t once[kLanes] = {0};
+    uint16_t twice[kLanes] = {0};
+    uint16_t seen[kLanes] = {0};
+    uint16_t full[kLanes] = {0};
+    for (int k = 0; k < 9; ++k) {
+      int c = kSudokuTables.unitCells[u][k];
+      for (int l = 0; l < kLanes; ++l) {
+        uint16_t open = value[c][l] ? static_cast<uint16_t>(0) : cand[c][l];
+        twice[l] |= once[l] & open;
+        once[l] |= open;
+        seen[l] |= value[c][l];
+        full[l] |= cand[c][l] | value[c][l];
+      }
+    }
+
+    uint16_t exact[kLanes];
+    for (int l = 0; l < kLanes; ++l) {
+      bad[l] |= (full[l] != kAllDigits) ? 1 : 0; // Some digit has no home
+      exact[l] = once[l] & static_cast<uint16_t>(~twice[l]) &
+                 static_cast<uint16_t>(~seen[l]);
+    }
+
+    for (int k = 0; k < 9; ++k) {
+      int c = kSudokuTables.unitCells[u][k];
+      uint16_t *cd = cand[c];
+      uint16_t *v = value[c];
+      for (int l = 0; l < kLanes; ++l) {
+        uint16_t hit = v[l] ? static_cast<uint16_t>(0) : (cd[l] & exact[l]);
+        uint16_t lowest = hit & static_cast<uint16_t>(-hit);
+        bad[l] |= (hit != lowest) ? 1 : 0; // One cell forced to two digits
+        v[l] |= lowest;
+        cd[l] = lowest ? lowest : cd[l];
+        changed[l] |= lowest;
+      }
+    }
+  }
+}
+
+std::string LockstepSolver::extractLane(int lane) const {
+  std::string out(81, '0');
+  for (int c = 0; c < 81; ++c) {
+    uint16_t v = value[c][lane];
+    for (int n = 1; n <= 9; ++n) {
+      if (v == (1 << n)) {
+        out[c] = static_cast<char>('0' + n);
+        break;
+      }
+    }
+  }
+  return out;
+}
+
+std::string LockstepSolver::finishScalar(int lane) const {
+  SudokuBoard board;
+  if (!board.loadFromString(extractLane(lane)))
+    return "";
+
+  Solver solver(board);
+  solver.setMode(Solver::Mode::BACKTRACK_ONLY);
+  if (!solver.solve())
+    return "";
+  return board.toString();
+}
+
+void LockstepSolver::solveBatch(const std::vector<std::string> &puzzles,
+                                std::vector<std::string> &solutions) {
+  solutions.assign(puzzles.size(), std::string());
+  stats = Stats();
+
+  size_t next = 0;
+  auto refill = [&](int lane) {
+    if (next < puzzles.size()) {
+      loadLane(lane, puzzles[next], static_cast<int>(next));
+      next++;
+    } else {
+      lanePuzzle[lane] = -1;
+    }
+  };
+
+  // Idle lanes keep their last puzzle's cells: every round still computes
+  // them, but their results are never read. Clearing a lane's cells (a
+  // stride-16 column) in this loop is what GCC 12.2 miscompiles at -O3:
+  // -fsplit-loops peels off the lanes past the end of the batch, and the
+  // vectorizer stores 8 of them with movaps from the first idle lane as if
+  // it were 16-byte aligned.
+  for (int l = 0; l < kLanes; ++l)
+    refill(l);
+
+  while (true) {
+    bool anyActive = false;
+    for (int l = 0; l < kLanes; ++l) {
+      if (lanePuzzle[l] >= 0)
+        anyActive = true;
+    }
+    if (!anyActive)
+      break;
+
+    uint16_t changed[kLanes] = {0};
+    uint16_t bad[kLanes] = {0};
+    propagateRound(changed, bad);
+    stats.rounds++;
+
+    uint16_t filled[kLanes] = {0};
+    for (int c = 0; c < 81; ++c) {
+      for (int l = 0; l < kLanes; ++l)
+        filled[l] += value[c][l] ? 1 : 0;
+    }
+
+    for (int l = 0; l < kLanes; ++l) {
+      int idx = lanePuzzle[l];
+      if (idx < 0)
+        continue;
+
+      // A lane is only accepted once a full round saw no change, so the
+      // duplicate check in step 1 has covered every placement.
+      if (bad[l]) {
+        stats.failed++;
+        refill(l);
+      } else if (changed[l]) {
+        continue;
+      } else if (filled[l] == 81) {
+        solutions[idx] = extractLane(l);
+        stats.propagated++;
+        refill(l);
+      } else {
+        // Propagation fixpoint reached: this puzzle needs branching.
+        solutions[idx] = finishScalar(l);
+        if (solutions[idx].empty())
+          stats.failed++;
+        else
+          stats.fallback++;
+        refill(l);
+      }
+    }
+  }
+}
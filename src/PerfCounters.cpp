@@ -0,0 +1,181 @@
+#include "PerfCounters.hpp"
+#include <chrono>
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstdint>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+double now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#ifdef __linux__
+struct EventSpec {
+  uint32_t type;
+  uint64_t config;
+};
+
+uint64_t cacheConfig(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+EventSpec specFor(PerfCounters::Event e) {
+  switch (e) {
+  case PerfCounters::CYCLES:
+    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+  case PerfCounters::INSTRUCTIONS:
+    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+  case PerfCounters::BRANCH_MISSES:
+    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+  case PerfCounters::L1D_MISSES:
+    return {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D)};
+  case PerfCounters::LLC_MISSES:
+    return {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_LL)};
+  default:
+    return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK};
+  }
+}
+
+// Counts user-space events of the calling thread on any CPU.
+int openEvent(PerfCounters::Event e, int groupFd, uint64_t readFormat) {
+  EventSpec spec = specFor(e);
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.read_format = readFormat;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+const uint64_t kScaled =
+    PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+// value * enabled / running; false if the event never ran.
+bool scale(uint64_t value, uint64_t enabled, uint64_t running, double &out) {
+  if (running == 0)
+    return false;
+  out = static_cast<double>(value);
+  if (running < enabled)
+    out *= static_cast<double>(enabled) / static_cast<double>(running);
+  return true;
+}
+#endif
+} // namespace
+
+PerfCounters::PerfCounters() : startTime(now()) {
+  for (int e = 0; e < kEventCount; ++e) {
+    fds[e] = -1;
+    groupIndex[e] = -1;
+  }
+
+#ifdef __linux__
+  for (int e = 0; e < TASK_CLOCK; ++e) {
+    int fd = openEvent(static_cast<Event>(e), groupLeader,
+                       kScaled | PERF_FORMAT_GROUP);
+    if (fd < 0) {
+      if (error.empty())
+        error = std::string(eventName(static_cast<Event>(e))) + ": " +
+                std::strerror(errno);
+      continue;
+    }
+    fds[e] = fd;
+    if (groupLeader < 0)
+      groupLeader = fd;
+    groupIndex[e] = groupSize++;
+  }
+  fds[TASK_CLOCK] = openEvent(TASK_CLOCK, -1, kScaled);
+  if (fds[TASK_CLOCK] < 0 && error.empty())
+    error = std::string(eventName(TASK_CLOCK)) + ": " + std::strerror(errno);
+#else
+  error = "perf_event_open needs Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  // Members before the leader
+  for (int e = kEventCount - 1; e >= 0; --e) {
+    if (fds[e] >= 0 && fds[e] != groupLeader)
+      close(fds[e]);
+  }
+  if (groupLeader >= 0)
+    close(groupLeader);
+#endif
+}
+
+bool PerfCounters::available(Event e) const { return fds[e] >= 0; }
+
+bool PerfCounters::hardwareAvailable() const { return groupLeader >= 0; }
+
+const std::string &PerfCounters::getError() const { return error; }
+
+PerfCounters::Sample PerfCounters::read() const {
+  Sample s;
+#ifdef __linux__
+  if (groupLeader >= 0) {
+    // { nr, time_enabled, time_running, value[nr] }
+    uint64_t buffer[3 + kEventCount];
+    ssize_t n = ::read(groupLeader, buffer, sizeof(buffer));
+    if (n >= static_cast<ssize_t>(3 * sizeof(uint64_t)) &&
+        buffer[0] == static_cast<uint64_t>(groupSize)) {
+      for (int e = 0; e < TASK_CLOCK; ++e) {
+        if (groupIndex[e] >= 0)
+          s.valid[e] = scale(buffer[3 + groupIndex[e]], buffer[1], buffer[2],
+                             s.values[e]);
+      }
+    }
+  }
+  if (fds[TASK_CLOCK] >= 0) {
+    uint64_t buffer[3]; // { value, time_enabled, time_running }
+    if (::read(fds[TASK_CLOCK], buffer, sizeof(buffer)) ==
+        static_cast<ssize_t>(sizeof(buffer)))
+      s.valid[TASK_CLOCK] =
+          scale(buffer[0], buffer[1], buffer[2], s.values[TASK_CLOCK]);
+  }
+#endif
+  s.seconds = now() - startTime;
+  return s;
+}
+
+PerfCounters::Sample PerfCounters::delta(const Sample &from,
+                                         const Sample &to) {
+  Sample d;
+  for (int e = 0; e < kEventCount; ++e) {
+    d.valid[e] = from.valid[e] && to.valid[e];
+    d.values[e] = d.valid[e] ? to.values[e] - from.values[e] : 0.0;
+  }
+  d.seconds = to.seconds - from.seconds;
+  return d;
+}
+
+const char *PerfCounters::eventName(Event e) {
+  switch (e) {
+  case CYCLES:
+    return "cycles";
+  case INSTRUCTIONS:
+    return "instructions";
+  case BRANCH_MISSES:
+    return "branch-misses";
+  case L1D_MISSES:
+    return "L1d-misses";
+  case LLC_MISSES:
+    return "LLC-misses";
+  case TASK_CLOCK:
+    return "task-clock-ns";
+  default:
+    return "?";
+  }
+}
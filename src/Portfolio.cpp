@@ -0,0 +1,79 @@
+#include "Portfolio.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+Portfolio::Portfolio()
+    : configs(defaultConfigs(
+          static_cast<int>(std::thread::hardware_concurrency()))) {}
+
+Portfolio::Portfolio(const std::vector<Config> &configs) : configs(configs) {}
+
+std::vector<Portfolio::Config> Portfolio::defaultConfigs(int threads) {
+  std::vector<Config> list;
+  list.push_back({"Hybrid (Logic + MRV)", Solver::Mode::HYBRID, 0});
+  list.push_back({"Pure MRV", Solver::Mode::BACKTRACK_ONLY, 0});
+  list.push_back({"SAT (CDCL)", Solver::Mode::SAT, 0});
+
+  unsigned int seed = 1;
+  while (static_cast<int>(list.size()) < std::max(threads, 4)) {
+    list.push_back({"Random Restarts (seed " + std::to_string(seed) + ")",
+                    Solver::Mode::RANDOM_RESTARTS, seed});
+    seed += 7919; // Keep per-restart seed ranges (seed + i) apart
+  }
+  return list;
+}
+
+void Portfolio::setConfigs(const std::vector<Config> &c) { configs = c; }
+
+const std::vector<Portfolio::Config> &Portfolio::getConfigs() const {
+  return configs;
+}
+
+Portfolio::Result Portfolio::solve(SudokuBoard &board) {
+  Result result;
+  auto start = std::chrono::steady_clock::now();
+
+  std::atomic<bool> done{false};
+  std::mutex winnerMutex;
+  SudokuBoard winningBoard;
+
+  std::vector<std::thread> workers;
+  workers.reserve(configs.size());
+  for (size_t i = 0; i < configs.size(); ++i) {
+    workers.emplace_back([&, i]() {
+      SudokuBoard local = board;
+      Solver solver(local);
+      solver.setMode(configs[i].mode);
+      solver.setSeed(configs[i].seed);
+      solver.setCancelFlag(&done);
+
+      bool solved = solver.solve() && local.isComplete();
+      if (solved) {
+        bool expected = false;
+        if (done.compare_exchange_strong(expected, true)) {
+          std::lock_guard<std::mutex> lock(winnerMutex);
+          winningBoard = local;
+          result.solved = true;
+          result.winnerIndex = static_cast<int>(i);
+          result.winner = configs[i].name;
+          result.winnerRecursions = solver.getRecursionCount();
+        }
+      } else if (!done && configs[i].mode != Solver::Mode::LOGIC_ONLY) {
+        // A complete search came back empty: no configuration can win.
+        done = true;
+      }
+    });
+  }
+  for (std::thread &t : workers)
+    t.join();
+
+  if (result.solved)
+    board = winningBoard;
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
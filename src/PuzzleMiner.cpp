@@ -0,0 +1,297 @@
+#include "PuzzleMiner.hpp"
+#include "EngineSelector.hpp"
+#include "Generator.hpp"
+#include "GridSampler.hpp"
+#include "Solver.hpp"
+#include "TranspositionTable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace {
+const char *const kMagic = "SDKELITE";
+const int kVersion = 1;
+
+// Per-thread table for uniqueness checks; dead positions and subtree counts
+// depend only on the digits, so it stays valid from one puzzle to the next.
+const size_t kTableEntries = 1 << 16;
+
+// HYBRID nodes are capped below this in the RATING score so they only
+// break ties between equal logic-left counts.
+const double kRatingTieBreak = 1e6;
+
+std::mt19937 rngFor(uint64_t seed, uint64_t stream, uint64_t index) {
+  std::seed_seq seq{static_cast<uint32_t>(seed),
+                    static_cast<uint32_t>(seed >> 32),
+                    static_cast<uint32_t>(stream),
+                    static_cast<uint32_t>(index)};
+  return std::mt19937(seq);
+}
+
+bool isUnique(SudokuBoard &board, TranspositionTable *table) {
+  Solver counter(board);
+  counter.setTranspositionTable(table);
+  return counter.countSolutions(2) == 1;
+}
+} // namespace
+
+PuzzleMiner::PuzzleMiner(const Options &options) : options(options) {}
+
+void PuzzleMiner::setProgressCallback(ProgressCallback callback) {
+  progress = std::move(callback);
+}
+
+const std::vector<PuzzleMiner::Elite> &PuzzleMiner::getArchive() const {
+  return archive;
+}
+
+const PuzzleMiner::Stats &PuzzleMiner::getStats() const { return stats; }
+
+std::string PuzzleMiner::objectiveName(Objective objective) {
+  switch (objective) {
+  case Objective::BACKTRACKS:
+    return "backtracks";
+  case Objective::NODES:
+    return "nodes";
+  case Objective::RATING:
+    return "rating";
+  }
+  return "backtracks";
+}
+
+bool PuzzleMiner::evaluate(const std::string &puzzle, Objective objective,
+                           TranspositionTable *table, Elite &out) {
+  SudokuBoard board;
+  if (!board.loadFromString(puzzle))
+    return false;
+  SudokuBoard check = board;
+  if (!isUnique(check, table))
+    return false;
+
+  Elite e;
+  e.puzzle = board.toString();
+  for (char ch : e.puzzle)
+    e.clues += ch != '0';
+
+  SudokuBoard hybridBoard = board;
+  Solver hybrid(hybridBoard);
+  hybrid.setMode(Solver::Mode::HYBRID);
+  if (!hybrid.solve() || !hybridBoard.isComplete())
+    return false;
+  e.solution = hybridBoard.toString();
+  e.backtracks = hybrid.getBacktrackCount();
+
+  SudokuBoard mrvBoard = board;
+  Solver mrv(mrvBoard);
+  mrv.setMode(Solver::Mode::BACKTRACK_ONLY);
+  mrv.solve();
+  e.nodes = mrv.getRecursionCount();
+
+  SudokuBoard logicBoard = board;
+  e.logicLeft = EngineSelector::extract(logicBoard).emptyAfterLogic;
+
+  if (objective == Objective::BACKTRACKS)
+    e.fitness = static_cast<double>(e.backtracks);
+  else if (objective == Objective::NODES)
+    e.fitness = static_cast<double>(e.nodes);
+  else
+    e.fitness = e.logicLeft * kRatingTieBreak +
+                std::min<double>(hybrid.getRecursionCount(),
+                                 kRatingTieBreak - 1);
+  out = std::move(e);
+  return true;
+}
+
+int PuzzleMiner::threadCount() const {
+  int threads = options.threads > 0
+                    ? options.threads
+                    : static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(threads, 1);
+}
+
+void PuzzleMiner::forEach(
+    int count, const std::function<void(int, TranspositionTable &)> &body) {
+  std::atomic<int> next{0};
+  auto worker = [&]() {
+    TranspositionTable table(kTableEntries);
+    for (int i = next++; i < count; i = next++)
+      body(i, table);
+  };
+  std::vector<std::thread> pool;
+  for (int t = 1; t < std::min(threadCount(), count); ++t)
+    pool.emplace_back(worker);
+  worker();
+  for (std::thread &t : pool)
+    t.join();
+}
+
+bool PuzzleMiner::addSeed(const std::string &puzzle) {
+  Elite e;
+  if (!evaluate(puzzle, options.objective, nullptr, e))
+    return false;
+  admit(std::move(e));
+  return true;
+}
+
+// Keeps the archive sorted hardest first; equal fitness keeps arrival order.
+bool PuzzleMiner::admit(Elite elite) {
+  for (const Elite &e : archive) {
+    if (e.puzzle == elite.puzzle)
+      return false;
+  }
+  if (static_cast<int>(archive.size()) >= options.archiveSize &&
+      elite.fitness <= archive.back().fitness)
+    return false;
+
+  auto pos = std::upper_bound(
+      archive.begin(), archive.end(), elite.fitness,
+      [](double f, const Elite &e) { return f > e.fitness; });
+  archive.insert(pos, std::move(elite));
+  if (static_cast<int>(archive.size()) > options.archiveSize)
+    archive.pop_back();
+  return true;
+}
+
+// A random grid with clues removed in random order while the solution stays
+// unique: a minimal puzzle.
+std::string PuzzleMiner::makeSeed(uint64_t index,
+                                  TranspositionTable &table) const {
+  GridSampler sampler(options.seed * 0x9E3779B97F4A7C15ull + index + 1);
+  SudokuBoard board;
+  sampler.sample(board);
+
+  std::mt19937 g = rngFor(options.seed, 0, index);
+  Generator::removeToMinimal(board, g, table);
+  return board.toString();
+}
+
+bool PuzzleMiner::makeChild(const std::vector<Elite> &parents, int generation,
+                            int index, TranspositionTable &table,
+                            Elite &child) const {
+  std::mt19937 g = rngFor(options.seed, 1 + generation, index);
+  auto pick = [&]() -> const Elite & {
+    return parents[g() % parents.size()];
+  };
+  const Elite &a = pick();
+  const Elite &b = pick();
+  const Elite &parent = a.fitness >= b.fitness ? a : b;
+
+  std::string grid = parent.puzzle;
+  int mutations = 1 + static_cast<int>(g() % 3);
+  for (int m = 0; m < mutations; ++m) {
+    std::vector<int> clues, empty;
+    for (int c = 0; c < 81; ++c)
+      (grid[c] != '0' ? clues : empty).push_back(c);
+
+    int op = static_cast<int>(g() % 3);
+    if (op == 0 && !empty.empty()) { // Add
+      int c = empty[g() % empty.size()];
+      grid[c] = parent.solution[c];
+    } else if (op == 1 && static_cast<int>(clues.size()) > options.minClues) {
+      grid[clues[g() % clues.size()]] = '0'; // Remove
+    } else if (!clues.empty() && !empty.empty()) { // Move
+      int from = clues[g() % clues.size()];
+      int to = empty[g() % empty.size()];
+      grid[from] = '0';
+      grid[to] = parent.solution[to];
+    }
+  }
+  if (grid == parent.puzzle)
+    return false;
+  return evaluate(grid, options.objective, &table, child);
+}
+
+const std::vector<PuzzleMiner::Elite> &PuzzleMiner::run() {
+  stats = Stats();
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  };
+
+  if (archive.empty()) {
+    int seeds = std::max(2, options.archiveSize / 2);
+    std::vector<Elite> made(seeds);
+    std::vector<char> ok(seeds, 0);
+    forEach(seeds, [&](int i, TranspositionTable &table) {
+      ok[i] = evaluate(makeSeed(i, table), options.objective, &table, made[i]);
+    });
+    for (int i = 0; i < seeds; ++i) {
+      if (ok[i])
+        admit(std::move(made[i]));
+    }
+  }
+  if (archive.empty())
+    return archive;
+
+  for (int gen = 0; gen < options.generations; ++gen) {
+    if (options.maxSeconds > 0.0 && elapsed() >= options.maxSeconds)
+      break;
+
+    std::vector<Elite> parents = archive;
+    std::vector<Elite> children(options.children);
+    std::vector<char> ok(options.children, 0);
+    std::atomic<long long> rejected{0};
+    forEach(options.children, [&](int i, TranspositionTable &table) {
+      ok[i] = makeChild(parents, gen, i, table, children[i]);
+      if (!ok[i])
+        rejected++;
+    });
+
+    stats.evaluated += options.children;
+    stats.rejected += rejected;
+    for (int i = 0; i < options.children; ++i) {
+      if (ok[i] && admit(std::move(children[i])))
+        stats.admitted++;
+    }
+    stats.generations++;
+    if (!options.archivePath.empty())
+      save(options.archivePath);
+    if (progress)
+      progress(gen, archive);
+  }
+  stats.seconds = elapsed();
+  return archive;
+}
+
+bool PuzzleMiner::save(const std::string &path) const {
+  std::string temp = path + ".tmp";
+  {
+    std::ofstream out(temp, std::ios::trunc);
+    if (!out)
+      return false;
+    out << kMagic << " " << kVersion << "\n";
+    out << "objective " << objectiveName(options.objective) << "\n";
+    for (const Elite &e : archive)
+      out << static_cast<long long>(e.fitness) << " " << e.backtracks << " "
+          << e.nodes << " " << e.logicLeft << " " << e.puzzle << "\n";
+    if (!out.flush())
+      return false;
+  }
+  return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+bool PuzzleMiner::load(const std::string &path) {
+  std::ifstream in(path);
+  std::string magic;
+  int version = 0;
+  if (!(in >> magic >> version) || magic != kMagic || version != kVersion)
+    return false;
+
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string word, last;
+    while (fields >> word)
+      last = word;
+    if (last.size() == 81)
+      addSeed(last);
+  }
+  return true;
+}
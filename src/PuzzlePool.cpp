@@ -0,0 +1,195 @@
+#include "PuzzlePool.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+const Generator::Difficulty kAllLevels[] = {
+    Generator::Difficulty::EASY, Generator::Difficulty::MEDIUM,
+    Generator::Difficulty::HARD, Generator::Difficulty::EXPERT,
+    Generator::Difficulty::MINIMAL};
+} // namespace
+
+PuzzlePool::PuzzlePool() : PuzzlePool(Options()) {}
+
+PuzzlePool::PuzzlePool(const Options &opts) : options(opts) {
+  options.highWatermark = std::max<size_t>(options.highWatermark, 1);
+  options.lowWatermark =
+      std::min(options.lowWatermark, options.highWatermark - 1);
+  if (options.levels.empty())
+    options.levels.assign(std::begin(kAllLevels), std::end(kAllLevels));
+  for (Generator::Difficulty level : options.levels)
+    levels[static_cast<int>(level)].enabled = true;
+
+  if (!options.persistPath.empty())
+    load(options.persistPath);
+}
+
+PuzzlePool::~PuzzlePool() {
+  stop();
+  if (!options.persistPath.empty())
+    save(options.persistPath);
+}
+
+void PuzzlePool::start() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!producers.empty())
+    return;
+  stopping = false;
+  for (int i = 0; i < std::max(options.producers, 1); ++i)
+    producers.emplace_back(&PuzzlePool::produce, this);
+}
+
+void PuzzlePool::stop() {
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+    threads.swap(producers);
+  }
+  wake.notify_all();
+  ready.notify_all();
+  for (std::thread &t : threads)
+    t.join();
+}
+
+bool PuzzlePool::tryPop(Generator::Difficulty level, SudokuBoard &board) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return takeLocked(static_cast<int>(level), board);
+}
+
+bool PuzzlePool::pop(Generator::Difficulty level, SudokuBoard &board) {
+  int index = static_cast<int>(level);
+  std::unique_lock<std::mutex> lock(mutex);
+  ready.wait(lock, [&]() {
+    return stopping || producers.empty() || !levels[index].enabled ||
+           !levels[index].puzzles.empty();
+  });
+  return takeLocked(index, board);
+}
+
+bool PuzzlePool::takeLocked(int level, SudokuBoard &board) {
+  Level &l = levels[level];
+  if (l.puzzles.empty())
+    return false;
+  board.loadFromString(l.puzzles.front());
+  l.puzzles.pop_front();
+  if (l.enabled && !l.refilling && l.puzzles.size() <= options.lowWatermark) {
+    l.refilling = true;
+    wake.notify_all();
+  }
+  return true;
+}
+
+size_t PuzzlePool::size(Generator::Difficulty level) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return levels[static_cast<int>(level)].puzzles.size();
+}
+
+long long PuzzlePool::getGenerated() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return generated;
+}
+
+// The emptiest level that is refilling and not already covered by puzzles
+// in flight.
+int PuzzlePool::pickLevelLocked() const {
+  int best = -1;
+  size_t bestFill = 0;
+  for (int i = 0; i < kLevels; ++i) {
+    const Level &l = levels[i];
+    size_t fill = l.puzzles.size() + l.inFlight;
+    if (!l.enabled || !l.refilling || fill >= options.highWatermark)
+      continue;
+    if (best < 0 || fill < bestFill) {
+      best = i;
+      bestFill = fill;
+    }
+  }
+  return best;
+}
+
+void PuzzlePool::produce() {
+  Generator generator; // Own sampler and RNG per thread
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    int level = pickLevelLocked();
+    if (level < 0) {
+      wake.wait(lock);
+      continue;
+    }
+
+    levels[level].inFlight++;
+    lock.unlock();
+    SudokuBoard board;
+    generator.generate(board, static_cast<Generator::Difficulty>(level));
+    lock.lock();
+
+    Level &l = levels[level];
+    l.inFlight--;
+    l.puzzles.push_back(board.toString());
+    generated++;
+    if (l.puzzles.size() >= options.highWatermark)
+      l.refilling = false;
+    ready.notify_all();
+  }
+}
+
+std::string PuzzlePool::levelName(Generator::Difficulty level) {
+  switch (level) {
+  case Generator::Difficulty::EASY:
+    return "easy";
+  case Generator::Difficulty::MEDIUM:
+    return "medium";
+  case Generator::Difficulty::HARD:
+    return "hard";
+  case Generator::Difficulty::EXPERT:
+    return "expert";
+  case Generator::Difficulty::MINIMAL:
+    return "minimal";
+  }
+  return "unknown";
+}
+
+bool PuzzlePool::save(const std::string &path) const {
+  std::string temp = path + ".tmp";
+  {
+    std::ofstream out(temp, std::ios::trunc);
+    if (!out)
+      return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Generator::Difficulty level : kAllLevels) {
+      for (const std::string &puzzle : levels[static_cast<int>(level)].puzzles)
+        out << levelName(level) << " " << puzzle << "\n";
+    }
+    if (!out.flush())
+      return false;
+  }
+  return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+bool PuzzlePool::load(const std::string &path) {
+  std::ifstream in(path);
+  if (!in)
+    return false;
+
+  std::string line;
+  std::lock_guard<std::mutex> lock(mutex);
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string name, puzzle;
+    SudokuBoard check;
+    if (!(fields >> name >> puzzle) || !check.loadFromString(puzzle))
+      continue;
+    for (Generator::Difficulty level : kAllLevels) {
+      if (levelName(level) == name) {
+        Level &l = levels[static_cast<int>(level)];
+        l.puzzles.push_back(check.toString());
+        l.refilling = l.puzzles.size() < options.highWatermark;
+      }
+    }
+  }
+  ready.notify_all();
+  return true;
+}
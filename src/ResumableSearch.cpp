@@ -0,0 +1,180 @@
+#include "ResumableSearch.hpp"
+#include "SudokuTables.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+const char *const kMagic = "SDKCHECKPOINT";
+constexpr int kVersion = 2;
+
+// Reads "<key> <value>" and checks the key.
+template <class T> bool readField(std::istream &in, const char *key, T &value) {
+  std::string name;
+  return (in >> name) && name == key && (in >> value);
+}
+} // namespace
+
+void ResumableSearch::start(const SudokuBoard &puzzle, long long limit,
+                            unsigned int seed) {
+  // Every digit becomes a given
+  this->puzzle.loadFromString(puzzle.toString());
+  board = this->puzzle;
+  state = Solver::SearchState();
+  solutionLimit = limit;
+  randomOrder = seed != 0;
+  rng.seed(seed);
+}
+
+void ResumableSearch::setCheckpointFile(const std::string &path,
+                                        long long everyNodes) {
+  checkpointPath = path;
+  checkpointEvery = everyNodes;
+}
+
+void ResumableSearch::setSolutionCallback(SolutionCallback callback) {
+  onSolution = std::move(callback);
+}
+
+void ResumableSearch::setCancelFlag(const std::atomic<bool> *flag) {
+  cancelFlag = flag;
+}
+
+bool ResumableSearch::run(long long maxNodes) {
+  long long budgetEnd = maxNodes > 0 ? state.nodes + maxNodes : LLONG_MAX;
+  long long nextCheckpoint =
+      checkpointEvery > 0 ? state.nodes + checkpointEvery : LLONG_MAX;
+
+  Solver solver(board);
+  solver.setCancelFlag(cancelFlag);
+  Solver::SearchOptions options;
+  options.limit = solutionLimit;
+  options.visit = onSolution;
+  options.rng = randomOrder ? &rng : nullptr;
+
+  // Slices end at the budget and at every checkpoint; the engine only
+  // stops between nodes, where the state on disk is complete.
+  while (!state.finished) {
+    if (state.nodes >= budgetEnd) {
+      checkpoint();
+      return false;
+    }
+    if (state.nodes >= nextCheckpoint) {
+      checkpoint();
+      nextCheckpoint += checkpointEvery;
+    }
+    options.maxNodes = std::min(budgetEnd, nextCheckpoint) - state.nodes;
+    Solver::SearchStop stop = solver.search(state, options);
+    if (stop == Solver::SearchStop::CANCELLED ||
+        stop == Solver::SearchStop::VISITOR) {
+      checkpoint();
+      return false;
+    }
+  }
+
+  checkpoint(); // Record completion so a resume does not redo the work
+  return true;
+}
+
+void ResumableSearch::checkpoint() const {
+  if (!checkpointPath.empty())
+    saveCheckpoint(checkpointPath);
+}
+
+bool ResumableSearch::saveCheckpoint(const std::string &path) const {
+  std::string temp = path + ".tmp";
+  {
+    std::ofstream out(temp, std::ios::trunc);
+    if (!out)
+      return false;
+    out << kMagic << " " << kVersion << "\n";
+    out << "puzzle " << puzzle.toString() << "\n";
+    out << "limit " << solutionLimit << "\n";
+    out << "nodes " << state.nodes << "\n";
+    out << "solutions " << state.solutions << "\n";
+    out << "expand " << state.expand << "\n";
+    out << "finished " << state.finished << "\n";
+    out << "random " << randomOrder << "\n";
+    out << "rng " << rng << "\n";
+    out << "frames " << state.depth << "\n";
+    for (int k = 0; k < state.depth; ++k) {
+      const Solver::SearchFrame &f = state.frames[k];
+      out << static_cast<int>(f.cell) << " " << static_cast<int>(f.placed)
+          << " " << f.remaining << "\n";
+    }
+    if (!out.flush())
+      return false;
+  }
+  return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+bool ResumableSearch::loadCheckpoint(const std::string &path) {
+  std::ifstream in(path);
+  std::string magic;
+  int version = 0;
+  if (!(in >> magic >> version) || magic != kMagic || version != kVersion)
+    return false;
+
+  std::string puzzleText;
+  long long limit, nodeCount, solutionCount;
+  bool expandFlag, finishedFlag, randomFlag;
+  std::mt19937 savedRng;
+  size_t frameCount;
+  SudokuBoard loaded;
+  if (!readField(in, "puzzle", puzzleText) ||
+      !loaded.loadFromString(puzzleText) || !readField(in, "limit", limit) ||
+      !readField(in, "nodes", nodeCount) ||
+      !readField(in, "solutions", solutionCount) ||
+      !readField(in, "expand", expandFlag) ||
+      !readField(in, "finished", finishedFlag) ||
+      !readField(in, "random", randomFlag) ||
+      !readField(in, "rng", savedRng) ||
+      !readField(in, "frames", frameCount) || frameCount > 81)
+    return false;
+
+  // Replay the path, checking that every digit is still legal. Frames keep
+  // the hash they were entered with; their solution counts only matter to
+  // a transposition table, which checkpointed searches do not use.
+  SudokuBoard replay = loaded;
+  Solver::SearchState replayed;
+  replayed.depth = static_cast<int>(frameCount);
+  for (size_t k = 0; k < frameCount; ++k) {
+    int cell, value, untried;
+    if (!(in >> cell >> value >> untried) || cell < 0 || cell >= 81 ||
+        value < 0 || value > 9 || (untried & ~0x3FE) != 0)
+      return false;
+    int row = kSudokuTables.rowOf[cell], col = kSudokuTables.colOf[cell];
+    if (replay.getValue(row, col) != 0)
+      return false;
+    Solver::SearchFrame &f = replayed.frames[k];
+    f.key = replay.getHash();
+    f.foundBefore = solutionCount;
+    f.remaining = static_cast<uint16_t>(untried);
+    f.cell = static_cast<uint8_t>(cell);
+    f.placed = static_cast<uint8_t>(value);
+    if (value != 0) {
+      if (!replay.isValid(row, col, value))
+        return false;
+      replay.placeNumber(row, col, value);
+    }
+  }
+  replayed.expand = expandFlag;
+  replayed.finished = finishedFlag;
+  replayed.nodes = nodeCount;
+  replayed.solutions = solutionCount;
+
+  puzzle = loaded;
+  board = replay;
+  state = replayed;
+  solutionLimit = limit;
+  randomOrder = randomFlag;
+  rng = savedRng;
+  return true;
+}
+
+bool ResumableSearch::isFinished() const { return state.finished; }
+long long ResumableSearch::getNodes() const { return state.nodes; }
+long long ResumableSearch::getSolutions() const { return state.solutions; }
+int ResumableSearch::getDepth() const { return state.depth; }
+const SudokuBoard &ResumableSearch::getBoard() const { return board; }
@@ -0,0 +1,442 @@
+#include "SatSolver.hpp"
+#include <algorithm>
+
+namespace {
+const double kVarDecay = 0.95;
+const double kClauseDecay = 0.999;
+const long long kRestartBase = 100; // Conflicts per Luby unit
+} // namespace
+
+CdclSolver::CdclSolver() {}
+
+int CdclSolver::newVar() {
+  int v = static_cast<int>(assigns.size());
+  assigns.push_back(kUndef);
+  level.push_back(0);
+  reason.push_back(-1);
+  polarity.push_back(1); // Try "false" first: most Sudoku literals are false
+  seen.push_back(0);
+  activity.push_back(0.0);
+  heapPos.push_back(-1);
+  watches.emplace_back();
+  watches.emplace_back();
+  heapInsert(v);
+  return v + 1;
+}
+
+int CdclSolver::numVars() const { return static_cast<int>(assigns.size()); }
+
+void CdclSolver::setCancelFlag(const std::atomic<bool> *flag) {
+  cancelFlag = flag;
+}
+
+long long CdclSolver::getDecisions() const { return decisions; }
+long long CdclSolver::getConflicts() const { return conflicts; }
+long long CdclSolver::getPropagations() const { return propagations; }
+long long CdclSolver::getLearnedClauses() const {
+  return static_cast<long long>(learnts.size());
+}
+
+bool CdclSolver::modelValue(int v) const {
+  return v >= 1 && v <= static_cast<int>(model.size()) && model[v - 1] == 1;
+}
+
+bool CdclSolver::addClause(const std::vector<int> &dimacs) {
+  if (!ok)
+    return false;
+  cancelUntil(0);
+
+  std::vector<int> lits;
+  lits.reserve(dimacs.size());
+  for (int d : dimacs)
+    lits.push_back(toInternal(d));
+  std::sort(lits.begin(), lits.end());
+
+  // Drop duplicates and literals false at the top level; skip tautologies
+  // and clauses that are already satisfied.
+  std::vector<int> kept;
+  int prev = -1;
+  for (int lit : lits) {
+    if (lit == prev)
+      continue;
+    if (prev >= 0 && lit == (prev ^ 1))
+      return true;
+    int8_t val = litValue(lit);
+    if (val == 1)
+      return true;
+    if (val == kUndef)
+      kept.push_back(lit);
+    prev = lit;
+  }
+
+  if (kept.empty()) {
+    ok = false;
+  } else if (kept.size() == 1) {
+    enqueue(kept[0], -1);
+    ok = (propagate() == -1);
+  } else {
+    attachClause(kept, false);
+  }
+  return ok;
+}
+
+int CdclSolver::attachClause(const std::vector<int> &lits, bool learnt) {
+  int index = static_cast<int>(clauses.size());
+  Clause c;
+  c.lits = lits;
+  c.learnt = learnt;
+  clauses.push_back(std::move(c));
+  watches[lits[0]].push_back({index, lits[1]});
+  watches[lits[1]].push_back({index, lits[0]});
+  if (learnt)
+    learnts.push_back(index);
+  return index;
+}
+
+void CdclSolver::enqueue(int lit, int from) {
+  int v = lit >> 1;
+  assigns[v] = static_cast<int8_t>(!(lit & 1));
+  level[v] = decisionLevel();
+  reason[v] = from;
+  trail.push_back(lit);
+}
+
+int CdclSolver::propagate() {
+  int conflict = -1;
+  while (qhead < trail.size()) {
+    int p = trail[qhead++];
+    int falseLit = p ^ 1;
+    std::vector<Watcher> &ws = watches[falseLit];
+    propagations++;
+
+    size_t i = 0, j = 0;
+    while (i < ws.size()) {
+      Watcher w = ws[i++];
+      if (litValue(w.blocker) == 1) {
+        ws[j++] = w;
+        continue;
+      }
+
+      Clause &c = clauses[w.clause];
+      if (c.deleted)
+        continue; // Lazily drop watchers of deleted clauses
+
+      // Keep the false literal in slot 1.
+      if (c.lits[0] == falseLit)
+        std::swap(c.lits[0], c.lits[1]);
+      int first = c.lits[0];
+      if (first != w.blocker && litValue(first) == 1) {
+        ws[j++] = {w.clause, first};
+        continue;
+      }
+
+      bool moved = false;
+      for (size_t k = 2; k < c.lits.size(); ++k) {
+        if (litValue(c.lits[k]) != 0) {
+          std::swap(c.lits[1], c.lits[k]);
+          watches[c.lits[1]].push_back({w.clause, first});
+          moved = true;
+          break;
+        }
+      }
+      if (moved)
+        continue;
+
+      ws[j++] = w;
+      if (litValue(first) == 0) {
+        conflict = w.clause;
+        qhead = trail.size();
+        while (i < ws.size())
+          ws[j++] = ws[i++];
+      } else {
+        enqueue(first, w.clause);
+      }
+    }
+    ws.resize(j);
+    if (conflict >= 0)
+      break;
+  }
+  return conflict;
+}
+
+void CdclSolver::analyze(int confl, std::vector<int> &learnt,
+                         int &backtrackLevel) {
+  learnt.clear();
+  learnt.push_back(-1); // Slot for the asserting (UIP) literal
+
+  int pathCount = 0;
+  int p = -1;
+  int index = static_cast<int>(trail.size()) - 1;
+
+  do {
+    Clause &c = clauses[confl];
+    if (c.learnt)
+      bumpClause(c);
+
+    // The implied literal of a reason clause is always lits[0].
+    for (size_t k = (p == -1 ? 0 : 1); k < c.lits.size(); ++k) {
+      int q = c.lits[k];
+      int v = q >> 1;
+      if (!seen[v] && level[v] > 0) {
+        seen[v] = 1;
+        bumpVar(v);
+        if (level[v] >= decisionLevel())
+          pathCount++;
+        else
+          learnt.push_back(q);
+      }
+    }
+
+    while (!seen[trail[index] >> 1])
+      index--;
+    p = trail[index];
+    index--;
+    confl = reason[p >> 1];
+    seen[p >> 1] = 0;
+    pathCount--;
+  } while (pathCount > 0);
+  learnt[0] = p ^ 1;
+
+  // Basic minimization: drop literals implied by others in the clause.
+  std::vector<int> original(learnt.begin() + 1, learnt.end());
+  size_t out = 1;
+  for (size_t k = 1; k < learnt.size(); ++k) {
+    int v = learnt[k] >> 1;
+    int r = reason[v];
+    bool redundant = r >= 0;
+    if (redundant) {
+      const Clause &rc = clauses[r];
+      for (size_t m = 1; m < rc.lits.size(); ++m) {
+        int u = rc.lits[m] >> 1;
+        if (!seen[u] && level[u] > 0) {
+          redundant = false;
+          break;
+        }
+      }
+    }
+    if (!redundant)
+      learnt[out++] = learnt[k];
+  }
+  learnt.resize(out);
+  for (int lit : original)
+    seen[lit >> 1] = 0;
+
+  // Second watch goes on the literal with the highest level.
+  backtrackLevel = 0;
+  if (learnt.size() > 1) {
+    size_t maxIndex = 1;
+    for (size_t k = 2; k < learnt.size(); ++k) {
+      if (level[learnt[k] >> 1] > level[learnt[maxIndex] >> 1])
+        maxIndex = k;
+    }
+    std::swap(learnt[1], learnt[maxIndex]);
+    backtrackLevel = level[learnt[1] >> 1];
+  }
+}
+
+void CdclSolver::cancelUntil(int lvl) {
+  if (decisionLevel() <= lvl)
+    return;
+  for (int k = static_cast<int>(trail.size()) - 1; k >= trailLim[lvl]; --k) {
+    int v = trail[k] >> 1;
+    polarity[v] = static_cast<int8_t>(trail[k] & 1);
+    assigns[v] = kUndef;
+    reason[v] = -1;
+    if (heapPos[v] < 0)
+      heapInsert(v);
+  }
+  trail.resize(trailLim[lvl]);
+  trailLim.resize(lvl);
+  qhead = trail.size();
+}
+
+int CdclSolver::pickBranchLit() {
+  while (!heap.empty()) {
+    int v = heapPop();
+    if (assigns[v] == kUndef)
+      return 2 * v + polarity[v];
+  }
+  return -1;
+}
+
+bool CdclSolver::isLocked(int clauseIndex) const {
+  const Clause &c = clauses[clauseIndex];
+  int v = c.lits[0] >> 1;
+  return reason[v] == clauseIndex && litValue(c.lits[0]) == 1;
+}
+
+void CdclSolver::reduceLearnts() {
+  std::sort(learnts.begin(), learnts.end(), [this](int a, int b) {
+    return clauses[a].activity < clauses[b].activity;
+  });
+
+  // Delete the less active half, keeping binaries and current reasons.
+  size_t half = learnts.size() / 2;
+  std::vector<int> kept;
+  kept.reserve(learnts.size());
+  for (size_t k = 0; k < learnts.size(); ++k) {
+    Clause &c = clauses[learnts[k]];
+    if (k < half && c.lits.size() > 2 && !isLocked(learnts[k])) {
+      c.deleted = true;
+      c.lits.clear();
+      c.lits.shrink_to_fit();
+    } else {
+      kept.push_back(learnts[k]);
+    }
+  }
+  learnts.swap(kept);
+}
+
+void CdclSolver::bumpVar(int v) {
+  activity[v] += varInc;
+  if (activity[v] > 1e100) {
+    for (double &a : activity)
+      a *= 1e-100;
+    varInc *= 1e-100;
+  }
+  if (heapPos[v] >= 0)
+    heapUp(heapPos[v]);
+}
+
+void CdclSolver::bumpClause(Clause &c) {
+  c.activity += clauseInc;
+  if (c.activity > 1e20) {
+    for (int idx : learnts)
+      clauses[idx].activity *= 1e-20;
+    clauseInc *= 1e-20;
+  }
+}
+
+void CdclSolver::heapInsert(int v) {
+  heapPos[v] = static_cast<int>(heap.size());
+  heap.push_back(v);
+  heapUp(heapPos[v]);
+}
+
+int CdclSolver::heapPop() {
+  int top = heap[0];
+  heapPos[top] = -1;
+  int last = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    heap[0] = last;
+    heapPos[last] = 0;
+    heapDown(0);
+  }
+  return top;
+}
+
+void CdclSolver::heapUp(int i) {
+  int v = heap[i];
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (activity[heap[parent]] >= activity[v])
+      break;
+    heap[i] = heap[parent];
+    heapPos[heap[i]] = i;
+    i = parent;
+  }
+  heap[i] = v;
+  heapPos[v] = i;
+}
+
+void CdclSolver::heapDown(int i) {
+  int v = heap[i];
+  int n = static_cast<int>(heap.size());
+  while (true) {
+    int child = 2 * i + 1;
+    if (child >= n)
+      break;
+    if (child + 1 < n && activity[heap[child + 1]] > activity[heap[child]])
+      child++;
+    if (activity[heap[child]] <= activity[v])
+      break;
+    heap[i] = heap[child];
+    heapPos[heap[i]] = i;
+    i = child;
+  }
+  heap[i] = v;
+  heapPos[v] = i;
+}
+
+long long CdclSolver::luby(int i) {
+  long long size = 1;
+  int seq = 0;
+  while (size < i + 1) {
+    seq++;
+    size = 2 * size + 1;
+  }
+  long long x = i;
+  while (size - 1 != x) {
+    size = (size - 1) >> 1;
+    seq--;
+    x = x % size;
+  }
+  return 1LL << seq;
+}
+
+CdclSolver::Result CdclSolver::solve() {
+  if (!ok)
+    return Result::UNSATISFIABLE;
+
+  model.clear();
+  maxLearnts = std::max(1000.0, clauses.size() / 3.0);
+  int restarts = 0;
+  long long conflictBudget = luby(0) * kRestartBase;
+  long long conflictsThisRun = 0;
+  std::vector<int> learnt;
+
+  while (true) {
+    int confl = propagate();
+    if (confl >= 0) {
+      conflicts++;
+      conflictsThisRun++;
+      if (decisionLevel() == 0) {
+        ok = false;
+        return Result::UNSATISFIABLE;
+      }
+
+      int backtrackLevel;
+      analyze(confl, learnt, backtrackLevel);
+      cancelUntil(backtrackLevel);
+      if (learnt.size() == 1) {
+        enqueue(learnt[0], -1);
+      } else {
+        int idx = attachClause(learnt, true);
+        bumpClause(clauses[idx]);
+        enqueue(learnt[0], idx);
+      }
+      varInc /= kVarDecay;
+      clauseInc /= kClauseDecay;
+      continue;
+    }
+
+    if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) {
+      cancelUntil(0);
+      return Result::UNKNOWN;
+    }
+
+    if (conflictsThisRun >= conflictBudget) {
+      cancelUntil(0);
+      restarts++;
+      conflictBudget = luby(restarts) * kRestartBase;
+      conflictsThisRun = 0;
+      continue;
+    }
+
+    if (static_cast<double>(learnts.size()) - trail.size() >= maxLearnts) {
+      reduceLearnts();
+      maxLearnts *= 1.1;
+    }
+
+    int next = pickBranchLit();
+    if (next < 0) {
+      model.assign(assigns.begin(), assigns.end());
+      cancelUntil(0);
+      return Result::SATISFIABLE;
+    }
+    decisions++;
+    trailLim.push_back(static_cast<int>(trail.size()));
+    enqueue(next, -1);
+  }
+}
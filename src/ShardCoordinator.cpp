@@ -0,0 +1,399 @@
+#include "ShardCoordinator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SHARD_USE_FORK 1
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+// CPUs this process may run on
+std::vector<int> usableCpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set))
+        cpus.push_back(cpu);
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    int n = static_cast<int>(std::thread::hardware_concurrency());
+    for (int cpu = 0; cpu < std::max(n, 1); ++cpu)
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+// Every workers-th CPU, starting at slot, so slots get disjoint sets.
+std::vector<int> cpusForSlot(const std::vector<int> &cpus, int slot,
+                             int workers) {
+  std::vector<int> mine;
+  for (size_t j = slot; j < cpus.size(); j += workers)
+    mine.push_back(cpus[j]);
+  if (mine.empty())
+    mine.push_back(cpus[slot % cpus.size()]);
+  return mine;
+}
+
+// Element-wise sum; total grows to the longer of the two.
+void addCounts(std::vector<long long> &total,
+               const std::vector<long long> &part) {
+  if (total.size() < part.size())
+    total.resize(part.size(), 0);
+  for (size_t i = 0; i < part.size(); ++i)
+    total[i] += part[i];
+}
+
+void addStats(BatchSolver::Stats &total, const BatchSolver::Stats &part) {
+  total.solved += part.solved;
+  total.failed += part.failed;
+  total.recursions += part.recursions;
+  total.backtracks += part.backtracks;
+  total.propagated += part.propagated;
+  total.fallback += part.fallback;
+  total.verified += part.verified;
+  total.rejected += part.rejected;
+  total.routedToPortfolio += part.routedToPortfolio;
+  total.estimateSeconds += part.estimateSeconds;
+  total.verifySeconds += part.verifySeconds;
+  addCounts(total.portfolioWins, part.portfolioWins);
+  addCounts(total.enginePicks, part.enginePicks);
+}
+
+#ifdef SHARD_USE_FORK
+struct ShardState {
+  long long begin, end;
+  int attempts = 0;
+  bool done = false;
+  std::vector<BatchSolver::Result> results;
+  BatchSolver::Stats stats;
+};
+
+struct Worker {
+  pid_t pid;
+  int fd;
+  int shard;
+  int slot;
+  std::string output;
+};
+
+void readCounts(const std::string &text, std::vector<long long> &counts) {
+  std::istringstream fields(text);
+  long long n;
+  while (fields >> n)
+    counts.push_back(n);
+}
+
+void writeCounts(FILE *out, const char *tag,
+                 const std::vector<long long> &counts) {
+  fputs(tag, out);
+  for (long long n : counts)
+    fprintf(out, " %lld", n);
+  fputc('\n', out);
+}
+
+// Worker output: one line per puzzle (solution or "-"), then
+// "#stats <solved> <failed> <recursions> <backtracks> <propagated>
+// <fallback> <verified> <rejected> <routed> <estimate s> <verify s>",
+// "#wins <per portfolio config>...", "#picks <per EngineSelector::Engine>..."
+// (both empty unless the engine collects them) and "#done <count>".
+bool parseWorkerOutput(const std::string &text, ShardState &shard) {
+  std::istringstream in(text);
+  std::vector<BatchSolver::Result> results;
+  BatchSolver::Stats stats;
+  std::string line;
+  bool done = false;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 7, "#stats ") == 0) {
+      std::istringstream fields(line.substr(7));
+      fields >> stats.solved >> stats.failed >> stats.recursions >>
+          stats.backtracks >> stats.propagated >> stats.fallback >>
+          stats.verified >> stats.rejected >> stats.routedToPortfolio >>
+          stats.estimateSeconds >> stats.verifySeconds;
+    } else if (line.compare(0, 5, "#wins") == 0) {
+      readCounts(line.substr(5), stats.portfolioWins);
+    } else if (line.compare(0, 6, "#picks") == 0) {
+      readCounts(line.substr(6), stats.enginePicks);
+    } else if (line.compare(0, 6, "#done ") == 0) {
+      done = std::atoll(line.c_str() + 6) ==
+             static_cast<long long>(results.size());
+    } else {
+      BatchSolver::Result r;
+      r.solved = line != "-";
+      if (r.solved)
+        r.solution = line;
+      results.push_back(std::move(r));
+    }
+  }
+  if (!done)
+    return false;
+  shard.results = std::move(results);
+  shard.stats = stats;
+  return true;
+}
+
+// Kills and reaps every running worker and closes its pipe, so a failed
+// run leaves no orphans, zombies or open descriptors behind.
+void stopWorkers(std::vector<Worker> &running) {
+  for (const Worker &w : running)
+    kill(w.pid, SIGKILL);
+  for (const Worker &w : running) {
+    close(w.fd);
+    while (waitpid(w.pid, nullptr, 0) < 0 && errno == EINTR) {
+    }
+  }
+  running.clear();
+}
+
+std::string systemError(const char *call) {
+  return std::string(call) + " failed: " + std::strerror(errno);
+}
+
+[[noreturn]] void runWorker(BatchSolver batch, const std::string &path,
+                            const ShardState &shard,
+                            const std::vector<int> &cpus, bool pin, int fd) {
+#ifdef __linux__
+  if (pin) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+      CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+  }
+#else
+  (void)pin;
+#endif
+
+  std::vector<std::string> puzzles;
+  if (!BatchSolver::readPuzzleRange(path, shard.begin, shard.end, puzzles))
+    _exit(1);
+  batch.setThreads(static_cast<int>(cpus.size()));
+  std::vector<BatchSolver::Result> results = batch.solveAll(puzzles);
+  const BatchSolver::Stats &s = batch.getStats();
+
+  FILE *out = fdopen(fd, "w");
+  if (!out)
+    _exit(1);
+  for (const BatchSolver::Result &r : results) {
+    fputs(r.solved ? r.solution.c_str() : "-", out);
+    fputc('\n', out);
+  }
+  fprintf(out,
+          "#stats %lld %lld %lld %lld %lld %lld %lld %lld %lld %.6f %.6f\n",
+          s.solved, s.failed, s.recursions, s.backtracks, s.propagated,
+          s.fallback, s.verified, s.rejected, s.routedToPortfolio,
+          s.estimateSeconds, s.verifySeconds);
+  writeCounts(out, "#wins", s.portfolioWins);
+  writeCounts(out, "#picks", s.enginePicks);
+  fprintf(out, "#done %zu\n", results.size());
+  _exit(fclose(out) == 0 ? 0 : 1);
+}
+#endif
+} // namespace
+
+ShardCoordinator::ShardCoordinator(const BatchSolver &batch,
+                                   const Options &options)
+    : batch(batch), options(options) {}
+
+void ShardCoordinator::setWorkerHook(WorkerHook hook) {
+  workerHook = std::move(hook);
+}
+
+const ShardCoordinator::Stats &ShardCoordinator::getStats() const {
+  return stats;
+}
+
+const std::string &ShardCoordinator::getError() const { return error; }
+
+std::vector<std::pair<long long, long long>>
+ShardCoordinator::splitFile(const std::string &path, int shards) {
+  std::vector<std::pair<long long, long long>> ranges;
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return ranges;
+  in.seekg(0, std::ios::end);
+  long long size = in.tellg();
+
+  long long begin = 0;
+  std::string rest;
+  for (int k = 1; k <= shards && begin < size; ++k) {
+    long long end = size;
+    if (k < shards) {
+      // Move the cut forward to the start of the next line
+      end = std::max(begin, size * k / shards);
+      in.clear();
+      in.seekg(end > 0 ? end - 1 : 0);
+      if (end > 0 && in.get() != '\n') {
+        std::getline(in, rest);
+        end = in ? static_cast<long long>(in.tellg()) : size;
+      }
+    }
+    if (end > begin)
+      ranges.push_back({begin, end});
+    begin = end;
+  }
+  return ranges;
+}
+
+bool ShardCoordinator::solve(const std::string &path,
+                             std::vector<BatchSolver::Result> &results) {
+  stats = Stats();
+  error.clear();
+  results.clear();
+  auto start = std::chrono::steady_clock::now();
+
+#ifndef SHARD_USE_FORK
+  std::vector<std::string> puzzles;
+  if (!BatchSolver::readPuzzleFile(path, puzzles)) {
+    error = "cannot read " + path;
+    return false;
+  }
+  results = batch.solveAll(puzzles);
+  stats.batch = batch.getStats();
+  stats.shards = 1;
+  stats.workers = 1;
+  return true;
+#else
+  std::vector<int> cpus = usableCpus();
+  int workers = options.workers > 0 ? options.workers
+                                    : static_cast<int>(cpus.size());
+  int shardCount = options.shards > 0 ? options.shards : workers * 4;
+  if (!std::ifstream(path)) {
+    error = "cannot read " + path;
+    return false;
+  }
+
+  std::vector<ShardState> shards;
+  for (const auto &range : splitFile(path, shardCount)) {
+    ShardState s;
+    s.begin = range.first;
+    s.end = range.second;
+    shards.push_back(std::move(s));
+  }
+  stats.shards = static_cast<int>(shards.size());
+  stats.workers = workers;
+
+  std::deque<int> pending;
+  for (size_t i = 0; i < shards.size(); ++i)
+    pending.push_back(static_cast<int>(i));
+  std::vector<Worker> running;
+  std::vector<char> slotBusy(workers, 0);
+
+  fflush(nullptr); // Children must not flush our buffered output again
+  while (!pending.empty() || !running.empty()) {
+    while (!pending.empty() && static_cast<int>(running.size()) < workers) {
+      int shard = pending.front();
+      pending.pop_front();
+      int slot = static_cast<int>(
+          std::find(slotBusy.begin(), slotBusy.end(), 0) - slotBusy.begin());
+
+      int fds[2];
+      if (pipe(fds) != 0) {
+        error = systemError("pipe");
+        stopWorkers(running);
+        return false;
+      }
+      pid_t pid = fork();
+      if (pid < 0) {
+        error = systemError("fork");
+        close(fds[0]);
+        close(fds[1]);
+        stopWorkers(running);
+        return false;
+      }
+      if (pid == 0) {
+        close(fds[0]);
+        for (const Worker &w : running)
+          close(w.fd);
+        if (workerHook)
+          workerHook(shard, shards[shard].attempts);
+        runWorker(batch, path, shards[shard],
+                  cpusForSlot(cpus, slot, workers), options.pin, fds[1]);
+      }
+      close(fds[1]);
+      shards[shard].attempts++;
+      slotBusy[slot] = 1;
+      running.push_back({pid, fds[0], shard, slot, std::string()});
+    }
+
+    std::vector<pollfd> polls;
+    for (const Worker &w : running)
+      polls.push_back({w.fd, POLLIN, 0});
+    if (poll(polls.data(), polls.size(), -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      error = systemError("poll");
+      stopWorkers(running);
+      return false;
+    }
+
+    for (size_t i = polls.size(); i-- > 0;) {
+      if (!(polls[i].revents & (POLLIN | POLLHUP | POLLERR)))
+        continue;
+      Worker &w = running[i];
+      char buffer[1 << 16];
+      ssize_t n = read(w.fd, buffer, sizeof(buffer));
+      if (n > 0) {
+        w.output.append(buffer, n);
+        continue;
+      }
+      if (n < 0 && errno == EINTR)
+        continue;
+
+      // End of output: reap the worker and keep or retry its shard
+      close(w.fd);
+      int status = 0;
+      waitpid(w.pid, &status, 0);
+      ShardState &shard = shards[w.shard];
+      bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                parseWorkerOutput(w.output, shard);
+      if (ok) {
+        shard.done = true;
+      } else if (shard.attempts < options.maxAttempts) {
+        stats.requeued++;
+        pending.push_back(w.shard);
+      } else {
+        stats.failedShards++;
+      }
+      slotBusy[w.slot] = 0;
+      running.erase(running.begin() + i);
+    }
+  }
+
+  for (ShardState &shard : shards) {
+    if (!shard.done) {
+      // Given up: report the shard's puzzles as unsolved
+      std::vector<std::string> puzzles;
+      BatchSolver::readPuzzleRange(path, shard.begin, shard.end, puzzles);
+      shard.results.assign(puzzles.size(), BatchSolver::Result());
+      shard.stats = BatchSolver::Stats();
+      shard.stats.failed = static_cast<long long>(puzzles.size());
+    }
+    addStats(stats.batch, shard.stats);
+    for (BatchSolver::Result &r : shard.results)
+      results.push_back(std::move(r));
+  }
+  stats.batch.seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  return true;
+#endif
+}
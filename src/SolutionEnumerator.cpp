@@ -0,0 +1,257 @@
+#include "SolutionEnumerator.hpp"
+#include "Solver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+// Subproblems per worker; the slack evens out subtrees of uneven size.
+constexpr size_t kTasksPerThread = 16;
+
+// Solutions a worker collects before taking the queue lock.
+constexpr size_t kPushBatch = 64;
+
+// MRV over the board; mask receives the chosen cell's candidates. Returns
+// false when no cell is empty.
+bool bestEmptyCell(const SudokuBoard &board, int &row, int &col, int &mask) {
+  int minCandidates = 10;
+  row = -1;
+  for (int r = 0; r < 9 && minCandidates > 1; ++r) {
+    for (int c = 0; c < 9; ++c) {
+      if (board.getValue(r, c) != 0)
+        continue;
+      int candidates = board.getCandidates(r, c);
+      int count = 0;
+      for (int m = candidates; m; m &= m - 1)
+        count++;
+      if (count < minCandidates) {
+        minCandidates = count;
+        row = r;
+        col = c;
+        mask = candidates;
+        if (count <= 1)
+          break;
+      }
+    }
+  }
+  return row != -1;
+}
+
+// Splits the root breadth-first until at least `target` open subproblems
+// exist (or the tree runs out). Positions already solved on the way go to
+// onSolution; returns false if it asked to stop.
+bool buildFrontier(const SudokuBoard &root, size_t target,
+                   const SolutionEnumerator::Sink &onSolution,
+                   std::vector<SudokuBoard> &frontier) {
+  std::deque<SudokuBoard> open{root};
+  while (!open.empty() && open.size() < target) {
+    SudokuBoard node = open.front();
+    open.pop_front();
+
+    int row = 0, col = 0, mask = 0;
+    if (!bestEmptyCell(node, row, col, mask)) {
+      if (!onSolution(node))
+        return false;
+      continue;
+    }
+    for (int num = 1; num <= 9; ++num) {
+      if (mask & (1 << num)) {
+        open.push_back(node);
+        open.back().placeNumber(row, col, num);
+      }
+    }
+  }
+  frontier.assign(open.begin(), open.end());
+  return true;
+}
+} // namespace
+
+SolutionEnumerator::SolutionEnumerator(int threads) : threadCount(threads) {
+  if (threadCount <= 0)
+    threadCount = static_cast<int>(std::thread::hardware_concurrency());
+  threadCount = std::max(threadCount, 1);
+}
+
+void SolutionEnumerator::setQueueCapacity(size_t capacity) {
+  queueCapacity = std::max<size_t>(capacity, 1);
+}
+
+void SolutionEnumerator::setCancelFlag(const std::atomic<bool> *flag) {
+  cancelFlag = flag;
+}
+
+SolutionEnumerator::Result
+SolutionEnumerator::enumerate(const SudokuBoard &board, const Sink &sink) {
+  Result result;
+  auto start = std::chrono::steady_clock::now();
+
+  std::atomic<bool> stop{false};
+  std::vector<SudokuBoard> frontier;
+  bool running = buildFrontier(board, threadCount * kTasksPerThread,
+                               [&](const SudokuBoard &solution) {
+                                 result.solutions++;
+                                 return sink(solution);
+                               },
+                               frontier);
+  if (!running)
+    stop = true;
+
+  std::mutex mutex;
+  std::condition_variable notFull, notEmpty;
+  std::deque<SudokuBoard> queue;
+  std::atomic<size_t> nextTask{0};
+  // Workers decrement active as they finish, so spawn from a fixed count.
+  int workerCount = static_cast<int>(
+      std::min(frontier.size(), static_cast<size_t>(threadCount)));
+  if (stop)
+    workerCount = 0;
+  int active = workerCount;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < workerCount; ++t) {
+    workers.emplace_back([&]() {
+      std::vector<SudokuBoard> pending;
+      pending.reserve(kPushBatch);
+      // Moves as much of pending as fits under the capacity; the rest
+      // waits for the next flush.
+      auto flush = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock,
+                     [&] { return queue.size() < queueCapacity || stop; });
+        if (stop)
+          return false;
+        size_t room = std::min(queueCapacity - queue.size(), pending.size());
+        queue.insert(queue.end(), pending.begin(), pending.begin() + room);
+        pending.erase(pending.begin(), pending.begin() + room);
+        notEmpty.notify_one();
+        return true;
+      };
+
+      while (!stop) {
+        size_t i = nextTask++;
+        if (i >= frontier.size())
+          break;
+        Solver solver(frontier[i]);
+        solver.setCancelFlag(&stop);
+        solver.enumerateSolutions([&](const SudokuBoard &solution) {
+          pending.push_back(solution);
+          return pending.size() < kPushBatch || flush();
+        });
+      }
+      while (!pending.empty() && flush()) {
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      active--;
+      notEmpty.notify_one();
+    });
+  }
+
+  // Drain on this thread so the sink never runs concurrently.
+  std::vector<SudokuBoard> batch;
+  while (!stop) {
+    bool finished;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      notEmpty.wait_for(lock, std::chrono::milliseconds(20),
+                        [&] { return !queue.empty() || active == 0; });
+      batch.assign(queue.begin(), queue.end());
+      queue.clear();
+      finished = active == 0 && batch.empty();
+    }
+    notFull.notify_all();
+
+    for (const SudokuBoard &solution : batch) {
+      result.solutions++;
+      if (!sink(solution)) {
+        running = false;
+        break;
+      }
+    }
+    if (!running || isCancelled()) {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    if (finished)
+      break;
+  }
+  notFull.notify_all();
+  for (std::thread &t : workers)
+    t.join();
+
+  result.complete = running && !isCancelled();
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+SolutionEnumerator::Result
+SolutionEnumerator::enumerate(const SudokuBoard &board, std::ostream &out) {
+  return enumerate(board, [&](const SudokuBoard &solution) {
+    out << solution.toString() << '\n';
+    return static_cast<bool>(out);
+  });
+}
+
+SolutionEnumerator::Result
+SolutionEnumerator::count(const SudokuBoard &board) {
+  Result result;
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<SudokuBoard> frontier;
+  buildFrontier(board, threadCount * kTasksPerThread,
+                [&](const SudokuBoard &) {
+                  result.solutions++;
+                  return true;
+                },
+                frontier);
+
+  std::atomic<bool> stop{false};
+  std::atomic<long long> total{0};
+  std::atomic<size_t> nextTask{0};
+  std::mutex mutex;
+  std::condition_variable done;
+  int workerCount = static_cast<int>(
+      std::min(frontier.size(), static_cast<size_t>(threadCount)));
+  int active = workerCount;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < workerCount; ++t) {
+    workers.emplace_back([&]() {
+      while (!stop) {
+        size_t i = nextTask++;
+        if (i >= frontier.size())
+          break;
+        Solver solver(frontier[i]);
+        solver.setCancelFlag(&stop);
+        total += solver.countSolutions();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      active--;
+      done.notify_one();
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (active > 0) {
+      done.wait_for(lock, std::chrono::milliseconds(20));
+      if (isCancelled())
+        stop = true;
+    }
+  }
+  for (std::thread &t : workers)
+    t.join();
+
+  result.solutions += total;
+  result.complete = !stop;
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
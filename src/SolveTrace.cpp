@@ -0,0 +1,202 @@
+#include "SolveTrace.hpp"
+
+namespace {
+const char kMagic[4] = {'S', 'D', 'K', 'T'};
+const uint8_t kVersion = 1;
+
+uint64_t zigzag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+} // namespace
+
+std::string techniqueToString(TraceTechnique t) {
+  switch (t) {
+  case TraceTechnique::GUESS:
+    return "Guess";
+  case TraceTechnique::NAKED_SINGLE:
+    return "Naked Single";
+  case TraceTechnique::HIDDEN_SINGLE_ROW:
+    return "Hidden Single (Row)";
+  case TraceTechnique::HIDDEN_SINGLE_COL:
+    return "Hidden Single (Col)";
+  case TraceTechnique::HIDDEN_SINGLE_BOX:
+    return "Hidden Single (Box)";
+  case TraceTechnique::SAT:
+    return "SAT Assignment";
+  default:
+    return "None";
+  }
+}
+
+// ---------------------------------------------------------------------------
+// TraceWriter
+// ---------------------------------------------------------------------------
+
+TraceWriter::~TraceWriter() { close(); }
+
+bool TraceWriter::open(const std::string &path, const SudokuBoard &initial) {
+  close();
+  out.open(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    return false;
+
+  buffer.clear();
+  buffer.reserve(kBufferSize);
+  for (char ch : kMagic)
+    buffer.push_back(static_cast<uint8_t>(ch));
+  buffer.push_back(kVersion);
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; ++c) {
+      buffer.push_back(static_cast<uint8_t>(initial.getValue(r, c)));
+    }
+  }
+
+  lastTime = std::chrono::steady_clock::now();
+  lastDepth = 0;
+  recordCount = 0;
+  failed = false;
+  return true;
+}
+
+bool TraceWriter::close() {
+  if (out.is_open()) {
+    flush();
+    out.close();
+    if (!out)
+      failed = true;
+  }
+  return !failed;
+}
+
+bool TraceWriter::isOpen() const { return out.is_open(); }
+
+uint64_t TraceWriter::getRecordCount() const { return recordCount; }
+
+void TraceWriter::record(TraceEvent event, TraceTechnique technique, int row,
+                         int col, int value, int depth) {
+  if (!out.is_open())
+    return;
+
+  auto now = std::chrono::steady_clock::now();
+  uint64_t deltaNs = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastTime)
+          .count());
+  lastTime = now;
+
+  uint8_t tag = static_cast<uint8_t>(static_cast<uint8_t>(event) |
+                                     (static_cast<uint8_t>(technique) << 2));
+  buffer.push_back(tag);
+  buffer.push_back(static_cast<uint8_t>(row * 9 + col));
+  buffer.push_back(static_cast<uint8_t>(value));
+  putVarint(zigzag(depth - lastDepth));
+  putVarint(deltaNs);
+  lastDepth = depth;
+  recordCount++;
+
+  // A record is at most 3 + 2 * 10 bytes; keep headroom so we never grow.
+  if (buffer.size() > kBufferSize - 32)
+    flush();
+}
+
+void TraceWriter::flush() {
+  if (!buffer.empty()) {
+    if (!out.write(reinterpret_cast<const char *>(buffer.data()),
+                   static_cast<std::streamsize>(buffer.size())))
+      failed = true;
+    buffer.clear();
+  }
+}
+
+void TraceWriter::putVarint(uint64_t v) {
+  while (v >= 0x80) {
+    buffer.push_back(static_cast<uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  buffer.push_back(static_cast<uint8_t>(v));
+}
+
+// ---------------------------------------------------------------------------
+// TraceReader
+// ---------------------------------------------------------------------------
+
+bool TraceReader::open(const std::string &path) {
+  in.open(path, std::ios::binary);
+  if (!in)
+    return false;
+
+  buffer.resize(kBufferSize);
+  pos = 0;
+  len = 0;
+  lastDepth = 0;
+
+  uint8_t header[5];
+  for (uint8_t &b : header) {
+    if (!getByte(b))
+      return false;
+  }
+  for (int i = 0; i < 4; ++i) {
+    if (header[i] != static_cast<uint8_t>(kMagic[i]))
+      return false;
+  }
+  if (header[4] != kVersion)
+    return false;
+
+  for (uint8_t &cell : initialGrid) {
+    if (!getByte(cell))
+      return false;
+  }
+  return true;
+}
+
+const uint8_t *TraceReader::getInitialGrid() const { return initialGrid; }
+
+bool TraceReader::next(TraceRecord &rec) {
+  uint8_t tag, cell, value;
+  if (!getByte(tag))
+    return false;
+  if (!getByte(cell) || !getByte(value))
+    return false;
+
+  uint64_t depthDelta, deltaNs;
+  if (!getVarint(depthDelta) || !getVarint(deltaNs))
+    return false;
+
+  rec.event = static_cast<TraceEvent>(tag & 0x3);
+  rec.technique = static_cast<TraceTechnique>((tag >> 2) & 0x7);
+  rec.cell = cell;
+  rec.value = value;
+  lastDepth += static_cast<int>(unzigzag(depthDelta));
+  rec.depth = lastDepth;
+  rec.deltaNs = deltaNs;
+  return true;
+}
+
+bool TraceReader::getByte(uint8_t &b) {
+  if (pos == len) {
+    in.read(reinterpret_cast<char *>(buffer.data()),
+            static_cast<std::streamsize>(buffer.size()));
+    len = static_cast<size_t>(in.gcount());
+    pos = 0;
+    if (len == 0)
+      return false;
+  }
+  b = buffer[pos++];
+  return true;
+}
+
+bool TraceReader::getVarint(uint64_t &v) {
+  v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t b;
+    if (!getByte(b))
+      return false;
+    v |= static_cast<uint64_t>(b & 0x7F) << shift;
+    if (!(b & 0x80))
+      return true;
+  }
+  return false;
+}
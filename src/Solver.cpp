@@ -1,21 +1,67 @@
 #include "Solver.hpp"
+#include "SolveTrace.hpp"
+#include "SudokuCnf.hpp"
+#include "TranspositionTable.hpp"
 #include <algorithm>
+#include <array>
 #include <climits>
 #include <iostream>
 #include <random>
 #include <string>
 #include <vector>
 
+namespace {
+// Heatmap counters have a single writer, so a relaxed load and store is
+// enough and avoids a locked read-modify-write per node.
+void bump(std::atomic<uint32_t> &counter) {
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+}
+} // namespace
+
 Solver::Solver(SudokuBoard &board) : board(board) {}
 
+Solver::Heatmap::Heatmap() { reset(); }
+
+void Solver::Heatmap::reset() {
+  for (int cell = 0; cell < 81; ++cell) {
+    branches[cell].store(0, std::memory_order_relaxed);
+    backtracks[cell].store(0, std::memory_order_relaxed);
+    changes[cell].store(0, std::memory_order_relaxed);
+  }
+  nodes.store(0, std::memory_order_relaxed);
+  depth.store(0, std::memory_order_relaxed);
+}
+
 void Solver::setStepCallback(
     std::function<void(int, int, int, std::string)> callback) {
   stepCallback = callback;
 }
 
+void Solver::setTraceWriter(TraceWriter *writer) { traceWriter = writer; }
+
+void Solver::setCancelFlag(const std::atomic<bool> *flag) { cancelFlag = flag; }
+
+void Solver::setTranspositionTable(TranspositionTable *table) {
+  transpositionTable = table;
+}
+
+void Solver::setHeatmap(Heatmap *map) { heatmap = map; }
+
 void Solver::setMode(Mode mode) { currentMode = mode; }
 Solver::Mode Solver::getMode() const { return currentMode; }
 
+void Solver::setRestartSchedule(RestartSchedule schedule, long long baseNodes,
+                                double growthFactor) {
+  restartSchedule = schedule;
+  restartBaseNodes = std::max(1LL, baseNodes);
+  restartGrowth = std::max(1.0, growthFactor);
+}
+
+void Solver::setSeed(unsigned int s) { seed = s; }
+unsigned int Solver::getWinningSeed() const { return winningSeed; }
+int Solver::getRestartCount() const { return restartCount; }
+
 long long Solver::getLogicCount() const { return logicCount; }
 long long Solver::getRecursionCount() const { return recursionCount; }
 long long Solver::getBacktrackCount() const { return backtrackCount; }
@@ -67,8 +113,12 @@ bool Solver::solve() {
   recursionCount = 0;
   backtrackCount = 0;
   logicCount = 0;
+  depth = 0;
+  restartCount = 0;
+  winningSeed = 0;
 
-  if (currentMode == Mode::LOGIC_ONLY || currentMode == Mode::HYBRID) {
+  if (currentMode == Mode::LOGIC_ONLY || currentMode == Mode::HYBRID ||
+      currentMode == Mode::RANDOM_RESTARTS) {
     solveHumanistic();
     if (currentMode == Mode::LOGIC_ONLY)
       return board.isComplete();
@@ -78,20 +128,200 @@ bool Solver::solve() {
     return true;
 
   if (currentMode == Mode::BACKTRACK_ONLY || currentMode == Mode::HYBRID) {
-    return solveRecursive();
+    return searchFirst(nullptr);
+  }
+  if (currentMode == Mode::RANDOM_RESTARTS) {
+    return solveWithRestarts();
+  }
+  if (currentMode == Mode::SAT) {
+    return solveSat();
   }
   return false;
 }
 
+namespace {
+// estimateSearch stops after kCheapProbes probes if their mean is below
+// kCheapTreeNodes.
+constexpr int kCheapProbes = 4;
+constexpr double kCheapTreeNodes = 1000.0;
+} // namespace
+
+Solver::TreeEstimate Solver::estimateSearch(int probes,
+                                            unsigned int probeSeed) {
+  TreeEstimate est;
+  SudokuBoard saved = board;
+  long long savedLogic = logicCount;
+  auto savedCallback = std::move(stepCallback);
+  TraceWriter *savedWriter = traceWriter;
+  stepCallback = nullptr;
+  traceWriter = nullptr;
+
+  if (currentMode == Mode::LOGIC_ONLY || currentMode == Mode::HYBRID ||
+      currentMode == Mode::RANDOM_RESTARTS) {
+    logicCount = 0;
+    solveHumanistic();
+    est.logicPlacements = static_cast<int>(logicCount);
+  }
+
+  if (!board.isComplete() && probes > 0) {
+    SudokuBoard root = board;
+    std::mt19937 g(probeSeed);
+    long long branchSum = 0, steps = 0;
+    double sum = 0.0, solutionSum = 0.0;
+    int done = 0;
+    for (; done < probes; ++done) {
+      // Small trees are cheaper to solve than to measure precisely
+      if (done == kCheapProbes &&
+          sum / done / (1.0 + solutionSum / done) < kCheapTreeNodes)
+        break;
+      board = root;
+      double weight = 1.0, total = 1.0;
+      int row, col;
+      bool solved = true;
+      while (findBestCell(row, col)) {
+        int mask = getCandidates(row, col);
+        int choices = countSetBits(mask);
+        if (choices == 0) {
+          est.deadEndProbes++;
+          solved = false;
+          break;
+        }
+        weight *= choices;
+        total += weight;
+        branchSum += choices;
+        steps++;
+
+        int pick = std::uniform_int_distribution<int>(0, choices - 1)(g);
+        int num = 1;
+        for (;; ++num) {
+          if ((mask & (1 << num)) && pick-- == 0)
+            break;
+        }
+        board.placeNumber(row, col, num);
+      }
+      sum += total;
+      if (solved)
+        solutionSum += weight; // Same estimator, counting solution leaves
+    }
+    est.treeNodes = sum / done;
+    est.solutions = solutionSum / done;
+    est.nodes = est.treeNodes / (1.0 + est.solutions);
+    est.meanBranching = steps ? static_cast<double>(branchSum) / steps : 0.0;
+    est.meanDepth = static_cast<double>(steps) / done;
+  }
+  est.seconds = est.nodes * kEstimatedSecondsPerNode;
+
+  board = saved;
+  logicCount = savedLogic;
+  stepCallback = std::move(savedCallback);
+  traceWriter = savedWriter;
+  return est;
+}
+
+bool Solver::solveSat() {
+  std::vector<int> grid(81);
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; ++c)
+      grid[r * 9 + c] = board.getValue(r, c);
+  }
+
+  SudokuCnf cnf(3);
+  CdclSolver sat;
+  sat.setCancelFlag(cancelFlag);
+  CdclSolver::Result result = cnf.encode(sat, grid)
+                                  ? sat.solve()
+                                  : CdclSolver::Result::UNSATISFIABLE;
+  recursionCount = sat.getDecisions();
+  backtrackCount = sat.getConflicts();
+  if (result != CdclSolver::Result::SATISFIABLE)
+    return false;
+
+  cnf.decode(sat, grid);
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; ++c) {
+      if (board.getValue(r, c) != 0)
+        continue;
+      int val = grid[r * 9 + c];
+      board.placeNumber(r, c, val);
+      if (traceWriter)
+        traceWriter->record(TraceEvent::PLACE, TraceTechnique::SAT, r, c, val,
+                            depth);
+      if (stepCallback)
+        stepCallback(r, c, val, "SAT Assignment: " + std::to_string(val));
+    }
+  }
+  return true;
+}
+
+long long Solver::restartBudget(int restart) const {
+  if (restartSchedule == RestartSchedule::GEOMETRIC) {
+    double budget = static_cast<double>(restartBaseNodes);
+    for (int i = 0; i < restart && budget < 1e15; ++i)
+      budget *= restartGrowth;
+    return static_cast<long long>(budget);
+  }
+
+  // Luby sequence: find the subsequence containing index `restart`, then
+  // recurse into it until the index lands on its final (largest) element.
+  long long size = 1;
+  int seq = 0;
+  while (size < restart + 1) {
+    seq++;
+    size = 2 * size + 1;
+  }
+  long long x = restart;
+  while (size - 1 != x) {
+    size = (size - 1) >> 1;
+    seq--;
+    x = x % size;
+  }
+  return restartBaseNodes << seq;
+}
+
+bool Solver::solveWithRestarts() {
+  unsigned int baseSeed = seed;
+  if (baseSeed == 0) {
+    std::random_device rd;
+    baseSeed = rd();
+  }
+
+  restartCount = 0;
+  while (true) {
+    unsigned int runSeed = baseSeed + static_cast<unsigned int>(restartCount);
+    std::mt19937 g(runSeed);
+    nodeLimit = restartBudget(restartCount);
+    limitReached = false;
+    depth = 0;
+
+    bool solved = searchFirst(&g);
+    nodeLimit = 0;
+
+    if (solved) {
+      winningSeed = runSeed;
+      return true;
+    }
+    // A run that finished within its budget explored the whole tree.
+    if (!limitReached || isCancelled())
+      return false;
+    restartCount++;
+    if (stepCallback)
+      stepCallback(-1, -1, 0, "Restart #" + std::to_string(restartCount));
+  }
+}
+
 bool Solver::solveRandomized() {
   recursionCount = 0;
   backtrackCount = 0;
+  depth = 0;
+  nodeLimit = 0;
+  limitReached = false;
   // We need a random engine.
   // Since we don't want to re-seed every recursive call, pass it down?
   // Or just construct it here.
   std::random_device rd;
-  std::mt19937 g(rd());
-  return solveRecursiveRandomized(g);
+  std::mt19937 g(seed != 0 ? seed : rd());
+  // Unobserved: a plain randomized fill (GridSampler) sends no steps
+  return searchFirst(&g, false);
 }
 
 int Solver::countSetBits(int n) {
@@ -103,9 +333,11 @@ int Solver::countSetBits(int n) {
   return count;
 }
 
-bool Solver::findBestCell(int &row, int &col) {
+bool Solver::findBestCell(int &row, int &col, std::mt19937 *rng,
+                          int *bestMask) {
   // MRV Heuristic: Find cell with minimum remaining candidates
   int minCandidates = 10;
+  int ties = 0;
   row = -1;
   col = -1;
 
@@ -118,8 +350,20 @@ bool Solver::findBestCell(int &row, int &col) {
           minCandidates = count;
           row = r;
           col = c;
-          if (minCandidates == 1)
-            return true; // Can't beat 1
+          ties = 1;
+          if (bestMask)
+            *bestMask = mask;
+          if (minCandidates == 0 || (minCandidates == 1 && !rng))
+            return true; // Can't beat 1 (0 is a dead end either way)
+        } else if (rng && count == minCandidates) {
+          // Reservoir sampling keeps each tied cell with equal probability
+          ties++;
+          if (std::uniform_int_distribution<int>(0, ties - 1)(*rng) == 0) {
+            row = r;
+            col = c;
+            if (bestMask)
+              *bestMask = mask;
+          }
         }
       }
     }
@@ -127,19 +371,14 @@ bool Solver::findBestCell(int &row, int &col) {
   return (row != -1);
 }
 
+// Only asked about empty cells, where this matches isValid digit by digit.
 int Solver::getCandidates(int row, int col) {
-  int mask = 0;
-  for (int n = 1; n <= 9; ++n) {
-    if (board.isValid(row, col, n)) {
-      mask |= (1 << n);
-    }
-  }
-  return mask;
+  return board.getCandidates(row, col);
 }
 
 bool Solver::solveHumanistic() {
   bool progress = true;
-  while (progress) {
+  while (progress && !isCancelled()) {
     progress = false;
     if (applyNakedSingles()) {
       progress = true;
@@ -174,6 +413,9 @@ bool Solver::applyNakedSingles() {
         }
         board.placeNumber(r, c, val);
         logicCount++;
+        if (traceWriter)
+          traceWriter->record(TraceEvent::LOGIC, TraceTechnique::NAKED_SINGLE,
+                              r, c, val, depth);
         if (stepCallback)
           stepCallback(r, c, val,
                        "Naked Single at (" + std::to_string(r) + "," +
@@ -210,6 +452,10 @@ bool Solver::applyHiddenSingles() {
       if (counts[n] == 1) {
         board.placeNumber(r, lastPos[n], n);
         logicCount++;
+        if (traceWriter)
+          traceWriter->record(TraceEvent::LOGIC,
+                              TraceTechnique::HIDDEN_SINGLE_ROW, r, lastPos[n],
+                              n, depth);
         if (stepCallback)
           stepCallback(r, lastPos[n], n,
                        "Hidden Single in Row " + std::to_string(r));
@@ -238,6 +484,10 @@ bool Solver::applyHiddenSingles() {
       if (counts[n] == 1) {
         board.placeNumber(lastPos[n], c, n);
         logicCount++;
+        if (traceWriter)
+          traceWriter->record(TraceEvent::LOGIC,
+                              TraceTechnique::HIDDEN_SINGLE_COL, lastPos[n], c,
+                              n, depth);
         if (stepCallback)
           stepCallback(lastPos[n], c, n,
                        "Hidden Single in Col " + std::to_string(c));
@@ -274,6 +524,10 @@ bool Solver::applyHiddenSingles() {
         if (counts[n] == 1) {
           board.placeNumber(lastPosR[n], lastPosC[n], n);
           logicCount++;
+          if (traceWriter)
+            traceWriter->record(TraceEvent::LOGIC,
+                                TraceTechnique::HIDDEN_SINGLE_BOX, lastPosR[n],
+                                lastPosC[n], n, depth);
           if (stepCallback)
             stepCallback(lastPosR[n], lastPosC[n], n,
                          "Hidden Single in Box (" + std::to_string(br) + "," +
@@ -287,51 +541,191 @@ bool Solver::applyHiddenSingles() {
   return false;
 }
 
-bool Solver::solveRecursive() {
-  recursionCount++;
-  int row, col;
-
-  // Use MRV to find best cell
-  if (!findBestCell(row, col))
-    return true; // No empty cells left
+// Depth-first MRV search on a fixed frame stack: one frame per guessed cell
+// holding its untried candidates, so the loop never allocates. A frame's
+// placed digit is its trail entry; undoing a level is a single
+// removeNumber. With an rng, ties between MRV cells and the digit tried
+// next are drawn at random. The engine only stops between nodes, where
+// the state is complete.
+Solver::SearchStop Solver::search(SearchState &s,
+                                  const SearchOptions &options) {
+  std::mt19937 *rng = options.rng;
+  bool observe = options.observe;
+  long long budgetEnd =
+      options.maxNodes > 0 ? s.nodes + options.maxNodes : LLONG_MAX;
+  // Cached counts stand in for a subtree only when its boards are not
+  // needed: not for a single solution, nor for a visitor.
+  bool useCounts = options.limit != 1 && !options.visit;
+  const char *tryReason = rng ? "Random Try: " : "Backtrack Try: ";
+
+  while (!s.finished) {
+    if (s.expand) {
+      if (isCancelled())
+        return SearchStop::CANCELLED;
+      if (s.nodes >= budgetEnd)
+        return SearchStop::BUDGET;
+      s.expand = false;
+      s.nodes++;
+      recursionCount++;
+      if (observe && heatmap) {
+        heatmap->nodes.store(recursionCount, std::memory_order_relaxed);
+        heatmap->depth.store(depth + s.depth, std::memory_order_relaxed);
+      }
 
-  for (int num = 1; num <= 9; num++) {
-    if (board.isValid(row, col, num)) {
-      board.placeNumber(row, col, num);
-      if (stepCallback)
-        stepCallback(row, col, num, "Backtrack Try: " + std::to_string(num));
+      uint64_t key = board.getHash();
+      long long cached = 0;
+      bool known = transpositionTable &&
+                   transpositionTable->lookupCount(key, cached) &&
+                   (cached == 0 || useCounts);
+      if (known) {
+        s.solutions += options.limit > 0
+                           ? std::min(cached, options.limit - s.solutions)
+                           : cached;
+      } else {
+        int row, col, mask = 0;
+        if (!findBestCell(row, col, rng, &mask)) {
+          s.solutions++;
+          bool keepGoing = !options.visit || options.visit(board);
+          if (options.limit > 0 && s.solutions >= options.limit) {
+            s.finished = true;
+            return SearchStop::FINISHED;
+          }
+          if (!keepGoing)
+            return SearchStop::VISITOR;
+        } else {
+          if (observe && heatmap)
+            bump(heatmap->branches[row * 9 + col]);
+          SearchFrame &f = s.frames[s.depth++];
+          f.key = key;
+          f.foundBefore = s.solutions;
+          f.remaining = static_cast<uint16_t>(mask);
+          f.cell = static_cast<uint8_t>(row * 9 + col);
+          f.placed = 0;
+        }
+      }
+      if (options.limit > 0 && s.solutions >= options.limit) {
+        s.finished = true;
+        return SearchStop::FINISHED;
+      }
+    }
 
-      if (solveRecursive())
-        return true;
+    if (s.depth == 0) {
+      s.finished = true;
+      break;
+    }
 
-      // Backtrack
-      board.removeNumber(row, col);
-      if (stepCallback)
-        stepCallback(row, col, 0, "Backtracking");
-      backtrackCount++;
+    // Take back the digit whose subtree is done, then try the next one
+    SearchFrame &f = s.frames[s.depth - 1];
+    if (f.placed)
+      undoGuess(f, s.depth, observe);
+    if (f.remaining) {
+      int num = 1;
+      if (rng) {
+        int count = countSetBits(f.remaining);
+        int pick = std::uniform_int_distribution<int>(0, count - 1)(*rng);
+        for (;; ++num) {
+          if ((f.remaining & (1 << num)) && pick-- == 0)
+            break;
+        }
+      } else {
+        while (!(f.remaining & (1 << num)))
+          num++;
+      }
+      f.remaining &= static_cast<uint16_t>(~(1 << num));
+      int row = f.cell / 9, col = f.cell % 9;
+      board.placeNumber(row, col, num);
+      f.placed = static_cast<uint8_t>(num);
+      if (observe) {
+        if (heatmap)
+          bump(heatmap->changes[f.cell]);
+        if (traceWriter)
+          traceWriter->record(TraceEvent::PLACE, TraceTechnique::GUESS, row,
+                              col, num, depth + s.depth);
+        if (stepCallback)
+          stepCallback(row, col, num, tryReason + std::to_string(num));
+      }
+      s.expand = true;
+      continue;
     }
+
+    // Exhausted: the count below this frame is exact (0 = dead position)
+    if (transpositionTable)
+      transpositionTable->storeCount(f.key, s.solutions - f.foundBefore);
+    s.depth--;
   }
-  return false;
+  return SearchStop::FINISHED;
 }
 
-bool Solver::solveRecursiveRandomized(std::mt19937 &g) {
-  recursionCount++;
-  int row, col;
-
-  if (!findBestCell(row, col))
-    return true;
+void Solver::undoGuess(SearchFrame &f, int frameDepth, bool observe) {
+  int row = f.cell / 9, col = f.cell % 9;
+  board.removeNumber(row, col);
+  f.placed = 0;
+  backtrackCount++;
+  if (observe) {
+    if (heatmap)
+      bump(heatmap->backtracks[f.cell]);
+    if (traceWriter)
+      traceWriter->record(TraceEvent::REMOVE, TraceTechnique::GUESS, row, col,
+                          0, depth + frameDepth);
+    if (stepCallback)
+      stepCallback(row, col, 0, "Backtracking");
+  }
+}
 
-  std::vector<int> numbers = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-  std::shuffle(numbers.begin(), numbers.end(), g);
+void Solver::abandonSearch(SearchState &state) {
+  for (int k = state.depth; k-- > 0;) {
+    SearchFrame &f = state.frames[k];
+    if (f.placed)
+      board.removeNumber(f.cell / 9, f.cell % 9);
+  }
+  state = SearchState();
+}
 
-  for (int num : numbers) {
-    if (board.isValid(row, col, num)) {
-      board.placeNumber(row, col, num);
-      if (solveRecursiveRandomized(g))
-        return true;
-      board.removeNumber(row, col);
-      backtrackCount++;
-    }
+bool Solver::searchFirst(std::mt19937 *rng, bool observe) {
+  SearchState state;
+  SearchOptions options;
+  options.limit = 1;
+  options.rng = rng;
+  options.maxNodes = nodeLimit;
+  options.observe = observe;
+  SearchStop stop = search(state, options);
+  if (stop == SearchStop::FINISHED && state.solutions > 0)
+    return true; // Every level keeps its digit
+
+  // Unwind what the run left on the board, as a finished search would have
+  limitReached = stop == SearchStop::BUDGET;
+  for (int k = state.depth; k-- > 0;) {
+    if (state.frames[k].placed)
+      undoGuess(state.frames[k], k + 1, observe);
   }
   return false;
 }
+
+long long Solver::countSolutions(long long limit) {
+  recursionCount = 0;
+  backtrackCount = 0;
+  depth = 0;
+  if (limit <= 0)
+    return 0;
+  SearchState state;
+  SearchOptions options;
+  options.limit = limit;
+  search(state, options);
+  long long found = state.solutions;
+  abandonSearch(state);
+  return found;
+}
+
+long long Solver::enumerateSolutions(
+    const std::function<bool(const SudokuBoard &)> &visit) {
+  recursionCount = 0;
+  backtrackCount = 0;
+  depth = 0;
+  SearchState state;
+  SearchOptions options;
+  options.visit = visit;
+  search(state, options);
+  long long found = state.solutions;
+  abandonSearch(state);
+  return found;
+}
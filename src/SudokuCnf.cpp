@@ -0,0 +1,95 @@
+#include "SudokuCnf.hpp"
+
+SudokuCnf::SudokuCnf(int boxSize) : boxSize(boxSize), n(boxSize * boxSize) {}
+
+int SudokuCnf::size() const { return n; }
+
+int SudokuCnf::variable(int row, int col, int value) const {
+  return (row * n + col) * n + value; // 1-based: value 1 of cell 0 is var 1
+}
+
+void SudokuCnf::addExactlyOne(CdclSolver &sat,
+                              const std::vector<int> &vars) const {
+  sat.addClause(vars);
+  for (size_t i = 0; i < vars.size(); ++i) {
+    for (size_t j = i + 1; j < vars.size(); ++j)
+      sat.addClause({-vars[i], -vars[j]});
+  }
+}
+
+bool SudokuCnf::encode(CdclSolver &sat, const std::vector<int> &grid) const {
+  // Row i, column i and box i, interleaved as the clauses always were
+  std::vector<std::vector<int>> units(3 * n, std::vector<int>(n));
+  for (int i = 0; i < n; ++i) {
+    int br = (i / boxSize) * boxSize;
+    int bc = (i % boxSize) * boxSize;
+    for (int k = 0; k < n; ++k) {
+      units[3 * i][k] = i * n + k;
+      units[3 * i + 1][k] = k * n + i;
+      units[3 * i + 2][k] = (br + k / boxSize) * n + bc + k % boxSize;
+    }
+  }
+  return encodeUnits(sat, units, grid);
+}
+
+bool SudokuCnf::encodeUnits(CdclSolver &sat,
+                            const std::vector<std::vector<int>> &units,
+                            const std::vector<int> &grid) const {
+  while (sat.numVars() < n * n * n)
+    sat.newVar();
+
+  std::vector<int> vars(n);
+  for (int r = 0; r < n; ++r) {
+    for (int c = 0; c < n; ++c) {
+      for (int v = 1; v <= n; ++v)
+        vars[v - 1] = variable(r, c, v);
+      addExactlyOne(sat, vars);
+    }
+  }
+
+  for (int v = 1; v <= n; ++v) {
+    for (const std::vector<int> &unit : units) {
+      for (int k = 0; k < n; ++k)
+        vars[k] = variable(unit[k] / n, unit[k] % n, v);
+      addExactlyOne(sat, vars);
+    }
+  }
+
+  bool consistent = true;
+  for (int r = 0; r < n; ++r) {
+    for (int c = 0; c < n; ++c) {
+      int v = grid[r * n + c];
+      if (v >= 1 && v <= n)
+        consistent = sat.addClause({variable(r, c, v)}) && consistent;
+    }
+  }
+  return consistent;
+}
+
+void SudokuCnf::decode(const CdclSolver &sat, std::vector<int> &grid) const {
+  grid.assign(n * n, 0);
+  for (int r = 0; r < n; ++r) {
+    for (int c = 0; c < n; ++c) {
+      for (int v = 1; v <= n; ++v) {
+        if (sat.modelValue(variable(r, c, v))) {
+          grid[r * n + c] = v;
+          break;
+        }
+      }
+    }
+  }
+}
+
+CdclSolver::Result SudokuCnf::solveGrid(int boxSize, std::vector<int> &grid,
+                                        const std::atomic<bool> *cancelFlag) {
+  SudokuCnf cnf(boxSize);
+  CdclSolver sat;
+  sat.setCancelFlag(cancelFlag);
+  if (!cnf.encode(sat, grid))
+    return CdclSolver::Result::UNSATISFIABLE;
+
+  CdclSolver::Result result = sat.solve();
+  if (result == CdclSolver::Result::SATISFIABLE)
+    cnf.decode(sat, grid);
+  return result;
+}
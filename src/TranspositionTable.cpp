@@ -0,0 +1,45 @@
+#include "TranspositionTable.hpp"
+
+TranspositionTable::TranspositionTable(size_t capacity) {
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+  entries.resize(size);
+  mask = size - 1;
+}
+
+void TranspositionTable::clear() {
+  for (Entry &e : entries)
+    e = Entry();
+  hits = 0;
+  probes = 0;
+}
+
+void TranspositionTable::storeDead(uint64_t key) { storeCount(key, 0); }
+
+bool TranspositionTable::isDead(uint64_t key) {
+  long long count;
+  return lookupCount(key, count) && count == 0;
+}
+
+void TranspositionTable::storeCount(uint64_t key, long long count) {
+  key = normalize(key);
+  Entry &e = entries[key & mask];
+  e.key = key;
+  e.count = count;
+}
+
+bool TranspositionTable::lookupCount(uint64_t key, long long &count) {
+  key = normalize(key);
+  probes++;
+  const Entry &e = entries[key & mask];
+  if (e.key != key)
+    return false;
+  hits++;
+  count = e.count;
+  return true;
+}
+
+size_t TranspositionTable::getCapacity() const { return entries.size(); }
+long long TranspositionTable::getHits() const { return hits; }
+long long TranspositionTable::getProbes() const { return probes; }
@@ -1,10 +1,22 @@
 #include "Visualizer.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 
+namespace {
+PuzzlePool::Options poolOptions() {
+  PuzzlePool::Options options;
+  options.levels = {Generator::Difficulty::HARD,
+                    Generator::Difficulty::MINIMAL};
+  options.persistPath = "puzzle_pool.txt";
+  return options;
+}
+} // namespace
+
 Visualizer::Visualizer(SudokuBoard &board, Solver &solver)
-    : board(board), solver(solver) {
+    : board(board), solver(solver), puzzlePool(poolOptions()) {
   if (!font.loadFromFile("assets/font.ttf")) {
     if (!font.loadFromFile("../assets/font.ttf")) {
       std::cerr << "Failed to load assets/font.ttf and ../assets/font.ttf. "
@@ -12,12 +24,16 @@ Visualizer::Visualizer(SudokuBoard &board, Solver &solver)
     }
   }
   initialBoard = board;
+  hints.load(board);
+  solver.setHeatmap(&heatmap);
+  puzzlePool.start();
 }
 
 Visualizer::~Visualizer() {
   if (solverThread.joinable()) {
     solverThread.join();
   }
+  solver.setHeatmap(nullptr);
 }
 
 void Visualizer::run() {
@@ -42,6 +58,22 @@ void Visualizer::processEvents() {
     if (event.type == sf::Event::Closed)
       window.close();
 
+    // Race view has its own few keys and no board editing
+    if (raceView) {
+      if (event.type != sf::Event::KeyPressed)
+        continue;
+      if (event.key.code == sf::Keyboard::Space) {
+        race.start(board);
+      } else if (event.key.code == sf::Keyboard::V) {
+        race.cancel();
+        raceView = false;
+      } else if (event.key.code == sf::Keyboard::Escape) {
+        race.cancel();
+        window.close();
+      }
+      continue;
+    }
+
     // Mouse Interaction
     if (event.type == sf::Event::MouseButtonPressed) {
       if (!solving && event.mouseButton.button == sf::Mouse::Left) {
@@ -63,6 +95,11 @@ void Visualizer::processEvents() {
     if (event.type == sf::Event::KeyPressed) {
       // Gameplay Controls (Only when not solving)
       if (!solving) {
+        if (hintsStale) {
+          hints.load(board);
+          hintsStale = false;
+        }
+
         // Arrow Keys Navigation
         if (selectedRow != -1 && selectedCol != -1) {
           if (event.key.code == sf::Keyboard::Up)
@@ -88,7 +125,13 @@ void Visualizer::processEvents() {
           if (!board.isFixed(selectedRow, selectedCol)) {
             if (board.isValid(selectedRow, selectedCol, numInput)) {
               board.placeNumber(selectedRow, selectedCol, numInput);
+              HintEngine::Verdict verdict =
+                  hints.place(selectedRow, selectedCol, numInput);
               currentReason = "Placed " + std::to_string(numInput);
+              if (verdict == HintEngine::Verdict::SOLVABLE)
+                currentReason += " - still solvable";
+              else if (verdict == HintEngine::Verdict::WRONG)
+                currentReason += " - wrong digit";
               checkWinCondition();
             } else {
               currentReason = "Invalid Move!";
@@ -104,9 +147,20 @@ void Visualizer::processEvents() {
             selectedRow != -1) {
           if (!board.isFixed(selectedRow, selectedCol)) {
             board.removeNumber(selectedRow, selectedCol);
+            hints.clear(selectedRow, selectedCol);
             currentReason = "Cleared cell";
           }
         }
+
+        // Hint: select the cell of the next easiest step
+        if (event.key.code == sf::Keyboard::H) {
+          HintEngine::Hint hint = hints.nextHint();
+          if (hint.row != -1) {
+            selectedRow = hint.row;
+            selectedCol = hint.col;
+          }
+          currentReason = "Hint: " + hint.text;
+        }
       }
 
       if (event.key.code == sf::Keyboard::Space) {
@@ -134,6 +188,8 @@ void Visualizer::processEvents() {
       if (event.key.code == sf::Keyboard::R) {
         if (!solving) {
           board = initialBoard;
+          hints.load(board);
+          hintsStale = false;
           // Reset visual state
           currentR = -1;
           currentC = -1;
@@ -144,11 +200,22 @@ void Visualizer::processEvents() {
           elapsed = sf::Time::Zero;
         }
       }
-      if (event.key.code == sf::Keyboard::G) {
+      if (event.key.code == sf::Keyboard::G ||
+          event.key.code == sf::Keyboard::M) {
         if (!solving) {
-          generator.generate(board, Generator::Difficulty::HARD);
+          bool minimal = event.key.code == sf::Keyboard::M;
+          Generator::Difficulty level = minimal
+                                            ? Generator::Difficulty::MINIMAL
+                                            : Generator::Difficulty::HARD;
+          // The pool is only empty right after startup or after many
+          // requests in a row; generating inline then is the old behavior.
+          if (!puzzlePool.tryPop(level, board))
+            generator.generate(board, level);
           initialBoard = board;
-          currentReason = "Generated New Hard Puzzle";
+          hints.load(board);
+          hintsStale = false;
+          currentReason = minimal ? "Generated New Minimal Puzzle"
+                                  : "Generated New Hard Puzzle";
           currentR = -1;
           currentC = -1;
           selectedRow = -1;
@@ -175,6 +242,50 @@ void Visualizer::processEvents() {
         if (selectedRow == -1)
           solver.setMode(Solver::Mode::HYBRID);
       }
+      if (event.key.code == sf::Keyboard::Num4) {
+        if (selectedRow == -1)
+          solver.setMode(Solver::Mode::RANDOM_RESTARTS);
+      }
+      if (event.key.code == sf::Keyboard::Num5) {
+        if (selectedRow == -1)
+          solver.setMode(Solver::Mode::SAT);
+      }
+      if (event.key.code == sf::Keyboard::Num6) {
+        if (selectedRow == -1 && !solving) {
+          SudokuBoard probe = board;
+          EngineSelector::Features f = EngineSelector::extract(probe);
+          EngineSelector::Engine engine = engineSelector.choose(f);
+          solver.setMode(EngineSelector::solverMode(engine));
+          std::stringstream why;
+          why << "Auto: " << EngineSelector::engineName(engine) << " ("
+              << f.emptyAfterLogic << " empty after singles, "
+              << std::fixed << std::setprecision(1) << f.meanCandidates
+              << " candidates each)";
+          currentReason = why.str();
+        }
+      }
+      if (event.key.code == sf::Keyboard::V) {
+        if (!solving) {
+          raceView = true;
+          race.start(board);
+        }
+      }
+      if (event.key.code == sf::Keyboard::O) {
+        switch (overlay) {
+        case Overlay::OFF:
+          overlay = Overlay::BRANCHES;
+          break;
+        case Overlay::BRANCHES:
+          overlay = Overlay::BACKTRACKS;
+          break;
+        case Overlay::BACKTRACKS:
+          overlay = Overlay::CHANGES;
+          break;
+        case Overlay::CHANGES:
+          overlay = Overlay::OFF;
+          break;
+        }
+      }
       if (event.key.code == sf::Keyboard::Add ||
           event.key.code == sf::Keyboard::Equal) {
         int s = speedDelayMs.load();
@@ -195,8 +306,16 @@ void Visualizer::processEvents() {
 
 void Visualizer::startSolving() {
   solving = true;
+  hintsStale = true;
   timer.restart();
   elapsed = sf::Time::Zero;
+  heatmap.reset();
+  depthHistory.clear();
+  rateNodes = 0;
+  nodesPerSecond = 0.0;
+  rateClock.restart();
+  if (solverThread.joinable())
+    solverThread.join();
   solverThread = std::thread([this]() {
     solver.solve();
     solving = false;
@@ -236,12 +355,38 @@ void Visualizer::render() {
     timer.restart(); // Don't accumulate time while paused
   }
 
+  if (raceView) {
+    drawRace();
+    window.display();
+    return;
+  }
+
+  sampleSearchStats();
   drawGrid();
   drawNumbers();
   drawInfo();
+  drawDepthGraph();
   window.display();
 }
 
+void Visualizer::sampleSearchStats() {
+  if (!solving)
+    return;
+
+  const size_t maxSamples = 540; // One pixel per sample under the board
+  depthHistory.push_back(heatmap.depth.load(std::memory_order_relaxed));
+  if (depthHistory.size() > maxSamples)
+    depthHistory.erase(depthHistory.begin());
+
+  float seconds = rateClock.getElapsedTime().asSeconds();
+  if (seconds >= 0.5f) {
+    long long nodes = heatmap.nodes.load(std::memory_order_relaxed);
+    nodesPerSecond = std::max(0LL, nodes - rateNodes) / seconds;
+    rateNodes = nodes;
+    rateClock.restart();
+  }
+}
+
 void Visualizer::drawGrid() {
   float cellSize = 60.0f;
   float startX = 50.0f;
@@ -275,6 +420,22 @@ void Visualizer::drawNumbers() {
   float startX = 50.0f;
   float startY = 50.0f;
 
+  // Heatmap: log-scaled against the hottest cell so a few thrashing cells do
+  // not wash out the rest
+  const std::atomic<uint32_t> *heat = nullptr;
+  if (overlay == Overlay::BRANCHES)
+    heat = heatmap.branches;
+  else if (overlay == Overlay::BACKTRACKS)
+    heat = heatmap.backtracks;
+  else if (overlay == Overlay::CHANGES)
+    heat = heatmap.changes;
+  uint32_t heatCounts[81] = {0};
+  uint32_t hottest = 0;
+  for (int k = 0; heat && k < 81; ++k) {
+    heatCounts[k] = heat[k].load(std::memory_order_relaxed);
+    hottest = std::max(hottest, heatCounts[k]);
+  }
+
   for (int i = 0; i < 9; ++i) {
     for (int j = 0; j < 9; ++j) {
       int val = board.getValue(i, j);
@@ -283,6 +444,27 @@ void Visualizer::drawNumbers() {
       sf::RectangleShape cell(sf::Vector2f(cellSize - 4, cellSize - 4));
       cell.setPosition(startX + j * cellSize + 2, startY + i * cellSize + 2);
 
+      uint32_t count = heatCounts[i * 9 + j];
+      if (count > 0) {
+        float t = std::log1p(static_cast<float>(count)) /
+                  std::log1p(static_cast<float>(hottest));
+        sf::RectangleShape heatCell(sf::Vector2f(cellSize - 4, cellSize - 4));
+        heatCell.setPosition(startX + j * cellSize + 2,
+                             startY + i * cellSize + 2);
+        heatCell.setFillColor(sf::Color(static_cast<int>(40 + 215 * t),
+                                        static_cast<int>(60 + 60 * (1 - t)),
+                                        static_cast<int>(120 * (1 - t)), 200));
+        window.draw(heatCell);
+
+        sf::Text label;
+        label.setFont(font);
+        label.setString(std::to_string(count));
+        label.setCharacterSize(11);
+        label.setFillColor(sf::Color(220, 220, 220));
+        label.setPosition(startX + j * cellSize + 5, startY + i * cellSize + 3);
+        window.draw(label);
+      }
+
       bool drawBg = false;
 
       // Active Cell (Blue)
@@ -350,6 +532,10 @@ void Visualizer::drawInfo() {
     modeStr = "Logic Only";
   if (solver.getMode() == Solver::Mode::BACKTRACK_ONLY)
     modeStr = "Backtrack Only";
+  if (solver.getMode() == Solver::Mode::RANDOM_RESTARTS)
+    modeStr = "Random Restarts";
+  if (solver.getMode() == Solver::Mode::SAT)
+    modeStr = "SAT (CDCL)";
 
   std::string reasonCopy;
   {
@@ -368,6 +554,16 @@ void Visualizer::drawInfo() {
   ss << "Recursions: " << solver.getRecursionCount() << "\n";
   ss << "Backtracks: " << solver.getBacktrackCount() << "\n";
   ss << "Logic Moves: " << solver.getLogicCount() << "\n";
+  if (solver.getMode() == Solver::Mode::RANDOM_RESTARTS)
+    ss << "Restarts: " << solver.getRestartCount() << "\n";
+  ss << "Nodes/s: " << std::setprecision(0) << nodesPerSecond << "\n";
+  if (overlay != Overlay::OFF) {
+    ss << "Heatmap: "
+       << (overlay == Overlay::BRANCHES     ? "Branches"
+           : overlay == Overlay::BACKTRACKS ? "Backtracks"
+                                            : "Changes")
+       << "\n";
+  }
 
   ss << "\n--- STATUS ---\n";
   if (paused)
@@ -376,6 +572,22 @@ void Visualizer::drawInfo() {
     ss << "[ SOLVING ]\n";
   else
     ss << "[ IDLE ]\n";
+  if (!solving && !hintsStale) {
+    switch (hints.getVerdict()) {
+    case HintEngine::Verdict::CHECKING:
+      ss << "Check: ...\n";
+      break;
+    case HintEngine::Verdict::SOLVABLE:
+      ss << "Check: Solvable\n";
+      break;
+    case HintEngine::Verdict::WRONG:
+      ss << "Check: Wrong Digit\n";
+      break;
+    case HintEngine::Verdict::NO_SOLUTION:
+      ss << "Check: No Solution\n";
+      break;
+    }
+  }
 
   ss << "\n--- REASON ---\n";
   // Wrap reason text
@@ -392,7 +604,12 @@ void Visualizer::drawInfo() {
   ss << "N     : Next Step (in Pause)\n";
   ss << "R     : Reset Board\n";
   ss << "G     : Generate New (Hard)\n";
-  ss << "1-3   : Mode Select\n";
+  ss << "M     : Generate New (Minimal)\n";
+  ss << "H     : Hint\n";
+  ss << "O     : Heatmap Overlay\n";
+  ss << "V     : Engine Race View\n";
+  ss << "1-5   : Mode Select\n";
+  ss << "6     : Auto Mode\n";
   ss << "+/-   : Speed (" << speedDelayMs.load() << "ms)\n";
   ss << "ESC   : Exit";
 
@@ -400,6 +617,124 @@ void Visualizer::drawInfo() {
   window.draw(text);
 }
 
+// Search depth over the last frames of the current (or last) solve, drawn
+// under the board.
+void Visualizer::drawDepthGraph() {
+  if (depthHistory.empty())
+    return;
+
+  float startX = 50.0f, startY = 605.0f;
+  float width = 540.0f, height = 80.0f;
+
+  sf::RectangleShape frame(sf::Vector2f(width, height));
+  frame.setPosition(startX, startY);
+  frame.setFillColor(sf::Color(30, 30, 45));
+  frame.setOutlineColor(sf::Color(80, 80, 100));
+  frame.setOutlineThickness(1);
+  window.draw(frame);
+
+  int deepest = std::max(1, *std::max_element(depthHistory.begin(),
+                                               depthHistory.end()));
+  sf::VertexArray line(sf::LineStrip, depthHistory.size());
+  for (size_t k = 0; k < depthHistory.size(); ++k) {
+    line[k].position =
+        sf::Vector2f(startX + static_cast<float>(k),
+                     startY + height - height * depthHistory[k] / deepest);
+    line[k].color = sf::Color(100, 200, 255);
+  }
+  window.draw(line);
+
+  sf::Text label;
+  label.setFont(font);
+  label.setCharacterSize(12);
+  label.setFillColor(sf::Color(180, 180, 180));
+  label.setString("Depth (max " + std::to_string(deepest) + ")");
+  label.setPosition(startX + 4, startY + 2);
+  window.draw(label);
+}
+
+// Two columns of panels: a mini-board per engine with its live counters to
+// the right.
+void Visualizer::drawRace() {
+  const float cellSize = 30.0f;
+  const float panelW = 490.0f, panelH = 330.0f;
+
+  for (size_t lane = 0; lane < race.size(); ++lane) {
+    float x = 20.0f + (lane % 2) * panelW;
+    float y = 20.0f + (lane / 2) * panelH;
+    EngineRace::Status status = race.getStatus(lane);
+    drawMiniBoard(race.getBoard(lane), x, y, cellSize);
+
+    std::string state = "Running";
+    if (status.finished && !status.solved)
+      state = status.place ? "No solution" : "Cancelled";
+    else if (status.finished)
+      state = "Solved (#" + std::to_string(status.place) + ")";
+
+    std::stringstream ss;
+    ss << race.getLane(lane).name << "\n\n";
+    ss << state << "\n";
+    ss << "Nodes: " << status.nodes << "\n";
+    ss << "Backtracks: " << status.backtracks << "\n";
+    ss << "Time: " << std::fixed << std::setprecision(3) << status.seconds
+       << "s\n";
+    ss << "Nodes/s: " << std::setprecision(0) << status.nodesPerSecond
+       << "\n";
+
+    sf::Text text;
+    text.setFont(font);
+    text.setCharacterSize(16);
+    text.setFillColor(status.place == 1 ? sf::Color(120, 230, 120)
+                                        : sf::Color::White);
+    text.setString(ss.str());
+    text.setPosition(x + 9 * cellSize + 15, y);
+    window.draw(text);
+  }
+
+  sf::Text footer;
+  footer.setFont(font);
+  footer.setCharacterSize(14);
+  footer.setFillColor(sf::Color(180, 180, 180));
+  footer.setString("Space: Restart Race    V: Back to Board    ESC: Exit");
+  footer.setPosition(20, 675);
+  window.draw(footer);
+}
+
+void Visualizer::drawMiniBoard(const SudokuBoard &mini, float x, float y,
+                               float cellSize) {
+  for (int i = 0; i <= 9; ++i) {
+    float thickness = i % 3 == 0 ? 2.0f : 1.0f;
+    sf::RectangleShape line(sf::Vector2f(9 * cellSize, thickness));
+    line.setFillColor(sf::Color(150, 150, 150));
+    line.setPosition(x, y + i * cellSize);
+    window.draw(line);
+
+    sf::RectangleShape vline(sf::Vector2f(thickness, 9 * cellSize));
+    vline.setFillColor(sf::Color(150, 150, 150));
+    vline.setPosition(x + i * cellSize, y);
+    window.draw(vline);
+  }
+
+  for (int i = 0; i < 9; ++i) {
+    for (int j = 0; j < 9; ++j) {
+      int val = mini.getValue(i, j);
+      if (val == 0)
+        continue;
+      sf::Text text;
+      text.setFont(font);
+      text.setString(std::to_string(val));
+      text.setCharacterSize(18);
+      text.setFillColor(mini.isFixed(i, j) ? sf::Color::White
+                                           : sf::Color::Yellow);
+      sf::FloatRect bounds = text.getLocalBounds();
+      text.setPosition(
+          x + j * cellSize + (cellSize - bounds.width) / 2 - bounds.left,
+          y + i * cellSize + (cellSize - bounds.height) / 2 - bounds.top);
+      window.draw(text);
+    }
+  }
+}
+
 void Visualizer::checkWinCondition() {
   if (board.isComplete()) {
     std::lock_guard<std::mutex> lock(reasonMutex);
@@ -0,0 +1,200 @@
+#include "BatchSolver.hpp"
+#include "ShardCoordinator.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Headless batch solver: one 81-character puzzle per line.
+
+namespace {
+void printUsage(const char *prog) {
+  std::cout << "Usage: " << prog
+            << " <puzzles.txt>"
+               " [--engine scalar|lockstep|portfolio|scheduled|adaptive]"
+               " [--mode hybrid|backtrack|logic|restarts|sat]"
+               " [--threads N] [--portfolio-above NODES]"
+               " [--verify on|off] [--processes N] [--shards N]"
+               " [--costs costs.txt] [--calibrate costs.txt]"
+               " [--out solutions.txt]\n";
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::string inputPath = argv[1];
+  std::string outputPath;
+  BatchSolver batch;
+  ShardCoordinator::Options sharding;
+  bool multiProcess = false;
+  std::string calibratePath;
+
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string opt = argv[i];
+    std::string val = argv[i + 1];
+    if (opt == "--engine") {
+      if (val == "lockstep")
+        batch.setEngine(BatchSolver::Engine::LOCKSTEP);
+      else if (val == "scalar")
+        batch.setEngine(BatchSolver::Engine::SCALAR);
+      else if (val == "portfolio")
+        batch.setEngine(BatchSolver::Engine::PORTFOLIO);
+      else if (val == "scheduled")
+        batch.setEngine(BatchSolver::Engine::SCHEDULED);
+      else if (val == "adaptive")
+        batch.setEngine(BatchSolver::Engine::ADAPTIVE);
+      else {
+        std::cerr << "Unknown engine: " << val << "\n";
+        return 1;
+      }
+    } else if (opt == "--mode") {
+      if (val == "hybrid")
+        batch.setMode(Solver::Mode::HYBRID);
+      else if (val == "backtrack")
+        batch.setMode(Solver::Mode::BACKTRACK_ONLY);
+      else if (val == "logic")
+        batch.setMode(Solver::Mode::LOGIC_ONLY);
+      else if (val == "restarts")
+        batch.setMode(Solver::Mode::RANDOM_RESTARTS);
+      else if (val == "sat")
+        batch.setMode(Solver::Mode::SAT);
+      else {
+        std::cerr << "Unknown mode: " << val << "\n";
+        return 1;
+      }
+    } else if (opt == "--threads") {
+      batch.setThreads(std::atoi(val.c_str()));
+    } else if (opt == "--portfolio-above") {
+      batch.setPortfolioThreshold(std::atof(val.c_str()));
+    } else if (opt == "--verify") {
+      batch.setVerify(val != "off");
+    } else if (opt == "--processes") {
+      sharding.workers = std::atoi(val.c_str());
+      multiProcess = true;
+    } else if (opt == "--shards") {
+      sharding.shards = std::atoi(val.c_str());
+      multiProcess = true;
+    } else if (opt == "--costs") {
+      EngineSelector selector;
+      if (!selector.load(val)) {
+        std::cerr << "Error: cannot read cost table " << val << "\n";
+        return 1;
+      }
+      batch.setSelector(selector);
+    } else if (opt == "--calibrate") {
+      calibratePath = val;
+    } else if (opt == "--out") {
+      outputPath = val;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (!calibratePath.empty()) {
+    // Offline: time every engine on the input and write the cost table
+    std::vector<std::string> puzzles;
+    if (!BatchSolver::readPuzzleFile(inputPath, puzzles)) {
+      std::cerr << "Error: cannot read " << inputPath << "\n";
+      return 1;
+    }
+    EngineSelector selector;
+    int measured = selector.calibrate(
+        puzzles,
+        {EngineSelector::Engine::MRV, EngineSelector::Engine::RESTARTS,
+         EngineSelector::Engine::SAT, EngineSelector::Engine::PORTFOLIO},
+        3);
+    if (!selector.save(calibratePath)) {
+      std::cerr << "Error: cannot write " << calibratePath << "\n";
+      return 1;
+    }
+    std::cout << "Calibrated  : " << measured << " puzzles needing search, "
+              << "table written to " << calibratePath << "\n";
+    return 0;
+  }
+
+  std::vector<BatchSolver::Result> results;
+  ShardCoordinator coordinator(batch, sharding);
+  if (multiProcess) {
+    if (!coordinator.solve(inputPath, results)) {
+      std::cerr << "Error: " << coordinator.getError() << "\n";
+      return 1;
+    }
+  } else {
+    std::vector<std::string> puzzles;
+    if (!BatchSolver::readPuzzleFile(inputPath, puzzles)) {
+      std::cerr << "Error: cannot read " << inputPath << "\n";
+      return 1;
+    }
+    results = batch.solveAll(puzzles);
+  }
+  const BatchSolver::Stats &stats =
+      multiProcess ? coordinator.getStats().batch : batch.getStats();
+
+  if (!outputPath.empty()) {
+    std::ofstream out(outputPath);
+    for (const BatchSolver::Result &r : results)
+      out << (r.solved ? r.solution : std::string("unsolvable")) << "\n";
+  }
+
+  std::cout << "Puzzles     : " << results.size() << "\n";
+  std::cout << "Solved      : " << stats.solved << "\n";
+  std::cout << "Failed      : " << stats.failed << "\n";
+  if (batch.getEngine() == BatchSolver::Engine::LOCKSTEP) {
+    std::cout << "Propagation : " << stats.propagated << "\n";
+    std::cout << "Fallback    : " << stats.fallback << "\n";
+  } else if (batch.getEngine() == BatchSolver::Engine::PORTFOLIO) {
+    const auto &configs = batch.getPortfolio().getConfigs();
+    // Empty when every shard was given up
+    if (stats.portfolioWins.size() == configs.size()) {
+      std::cout << "Wins        :\n";
+      for (size_t i = 0; i < configs.size(); ++i)
+        std::cout << "  " << configs[i].name << " : "
+                  << stats.portfolioWins[i] << "\n";
+    }
+  } else {
+    std::cout << "Recursions  : " << stats.recursions << "\n";
+    std::cout << "Backtracks  : " << stats.backtracks << "\n";
+  }
+  if (batch.getEngine() == BatchSolver::Engine::ADAPTIVE &&
+      stats.enginePicks.size() == EngineSelector::kEngines) {
+    std::cout << "Picks       :";
+    for (int e = 0; e < EngineSelector::kEngines; ++e) {
+      if (stats.enginePicks[e] > 0)
+        std::cout << " "
+                  << EngineSelector::engineName(
+                         static_cast<EngineSelector::Engine>(e))
+                  << " " << stats.enginePicks[e];
+    }
+    std::cout << "\n";
+  }
+  if (batch.getEngine() == BatchSolver::Engine::SCHEDULED) {
+    std::cout << "Estimation  : " << std::fixed << std::setprecision(3)
+              << stats.estimateSeconds << "s\n";
+    std::cout << "Portfolio   : " << stats.routedToPortfolio << " puzzles\n";
+  }
+  if (multiProcess) {
+    const ShardCoordinator::Stats &shardStats = coordinator.getStats();
+    std::cout << "Shards      : " << shardStats.shards << " over "
+              << shardStats.workers << " processes, " << shardStats.requeued
+              << " requeued, " << shardStats.failedShards << " failed\n";
+  }
+  if (stats.verified + stats.rejected > 0) {
+    std::cout << "Verified    : " << stats.verified << " ok, "
+              << stats.rejected << " rejected in " << std::fixed
+              << std::setprecision(4) << stats.verifySeconds << "s\n";
+  }
+  std::cout << "Time        : " << std::fixed << std::setprecision(3)
+            << stats.seconds << "s\n";
+  if (stats.seconds > 0)
+    std::cout << "Throughput  : " << std::setprecision(0)
+              << results.size() / stats.seconds << " puzzles/s\n";
+
+  return stats.failed == 0 ? 0 : 2;
+}
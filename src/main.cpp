@@ -1,23 +1,26 @@
+#include "ConstexprSolver.hpp"
 #include "Solver.hpp"
 #include "SudokuBoard.hpp"
 #include "Visualizer.hpp"
 #include <iostream>
-#include <vector>
 
+// Sample board, parsed and checked for a unique solution at compile time
+constexpr SudokuBoard kSampleBoard = ConstexprSolver::parse("530070000"
+                                                            "600195000"
+                                                            "098000060"
+                                                            "800060003"
+                                                            "400803001"
+                                                            "700020006"
+                                                            "060000280"
+                                                            "000419005"
+                                                            "000080079");
+static_assert(ConstexprSolver::countSolutions(kSampleBoard, 2) == 1,
+              "the sample board must have exactly one solution");
 
 int main() {
   std::cout << "Starting Sudoku Visualizer...\n";
 
-  SudokuBoard board;
-  // Sample board
-  std::vector<std::vector<int>> sampleGrid = {
-      {5, 3, 0, 0, 7, 0, 0, 0, 0}, {6, 0, 0, 1, 9, 5, 0, 0, 0},
-      {0, 9, 8, 0, 0, 0, 0, 6, 0}, {8, 0, 0, 0, 6, 0, 0, 0, 3},
-      {4, 0, 0, 8, 0, 3, 0, 0, 1}, {7, 0, 0, 0, 2, 0, 0, 0, 6},
-      {0, 6, 0, 0, 0, 0, 2, 8, 0}, {0, 0, 0, 4, 1, 9, 0, 0, 5},
-      {0, 0, 0, 0, 8, 0, 0, 7, 9}};
-
-  board.loadBoard(sampleGrid);
+  SudokuBoard board = kSampleBoard;
 
   Solver solver(board);
   Visualizer visualizer(board, solver);
@@ -0,0 +1,99 @@
+#include "PuzzleMiner.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Headless hardest-puzzle miner: evolves unique puzzles that maximize solver
+// effort and keeps an elite archive on disk.
+
+namespace {
+void printUsage(const char *prog) {
+  std::cout << "Usage: " << prog
+            << " [--objective backtracks|nodes|rating] [--generations N]"
+               " [--seconds S] [--threads N] [--children N] [--size N]"
+               " [--seed N] [--archive elite.txt] [--resume on|off]\n";
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  PuzzleMiner::Options options;
+  options.archivePath = "elite.txt";
+  bool resume = true;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string opt = argv[i];
+    std::string val = argv[i + 1];
+    if (opt == "--objective") {
+      if (val == "backtracks")
+        options.objective = PuzzleMiner::Objective::BACKTRACKS;
+      else if (val == "nodes")
+        options.objective = PuzzleMiner::Objective::NODES;
+      else if (val == "rating")
+        options.objective = PuzzleMiner::Objective::RATING;
+      else {
+        std::cerr << "Unknown objective: " << val << "\n";
+        return 1;
+      }
+    } else if (opt == "--generations") {
+      options.generations = std::atoi(val.c_str());
+    } else if (opt == "--seconds") {
+      options.maxSeconds = std::atof(val.c_str());
+    } else if (opt == "--threads") {
+      options.threads = std::atoi(val.c_str());
+    } else if (opt == "--children") {
+      options.children = std::max(1, std::atoi(val.c_str()));
+    } else if (opt == "--size") {
+      options.archiveSize = std::max(2, std::atoi(val.c_str()));
+    } else if (opt == "--seed") {
+      options.seed = std::strtoull(val.c_str(), nullptr, 10);
+    } else if (opt == "--archive") {
+      options.archivePath = val;
+    } else if (opt == "--resume") {
+      resume = val != "off";
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc % 2 == 0) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  PuzzleMiner miner(options);
+  if (resume && miner.load(options.archivePath))
+    std::cout << "Resumed     : " << miner.getArchive().size()
+              << " puzzles from " << options.archivePath << "\n";
+
+  miner.setProgressCallback(
+      [](int generation, const std::vector<PuzzleMiner::Elite> &archive) {
+        const PuzzleMiner::Elite &best = archive.front();
+        std::cout << "Gen " << std::setw(4) << generation + 1 << " : best "
+                  << std::setw(10) << static_cast<long long>(best.fitness)
+                  << " (" << best.backtracks << " backtracks, " << best.nodes
+                  << " nodes, " << best.clues << " clues), weakest "
+                  << static_cast<long long>(archive.back().fitness) << "\n";
+      });
+  const std::vector<PuzzleMiner::Elite> &archive = miner.run();
+  if (archive.empty()) {
+    std::cerr << "Error: no starting puzzles\n";
+    return 1;
+  }
+
+  const PuzzleMiner::Stats &stats = miner.getStats();
+  std::cout << "Objective   : "
+            << PuzzleMiner::objectiveName(options.objective) << "\n";
+  std::cout << "Generations : " << stats.generations << "\n";
+  std::cout << "Children    : " << stats.evaluated << " (" << stats.rejected
+            << " rejected, " << stats.admitted << " admitted)\n";
+  std::cout << "Time        : " << std::fixed << std::setprecision(2)
+            << stats.seconds << "s\n";
+  std::cout << "Hardest     :\n";
+  for (size_t i = 0; i < std::min<size_t>(5, archive.size()); ++i)
+    std::cout << "  " << archive[i].puzzle << "  "
+              << static_cast<long long>(archive[i].fitness) << "\n";
+  if (!options.archivePath.empty())
+    std::cout << "Archive     : " << options.archivePath << "\n";
+  return 0;
+}
@@ -0,0 +1,262 @@
+#include "BatchSolver.hpp"
+#include "PerfCounters.hpp"
+#include "Solver.hpp"
+#include "SudokuBoard.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Hardware counter profile of solver runs, per puzzle and per phase: the
+// logic pass (naked/hidden singles) and the search that finishes the board
+// (MRV backtracking, restarts or SAT, depending on the mode). Tells whether
+// a phase is bound by instructions, branch misses or cache misses before
+// anyone starts optimizing it.
+
+namespace {
+
+enum Phase { LOGIC, SEARCH, kPhases };
+
+struct PuzzleProfile {
+  size_t index;
+  PerfCounters::Sample phase[kPhases];
+};
+
+void printUsage(const char *prog) {
+  std::cout << "Usage: " << prog << " <puzzles.txt>"
+            << " [--mode hybrid|backtrack|logic|restarts|sat]"
+            << " [--top N] [--csv out.csv]\n"
+            << "  --top N  Puzzles with the costliest search to list"
+               " (default 5)\n"
+            << "  --csv    One line per puzzle and phase\n";
+}
+
+// Zero counts, valid until a missing part is added
+PerfCounters::Sample emptyTotal() {
+  PerfCounters::Sample s;
+  for (int e = 0; e < PerfCounters::kEventCount; ++e)
+    s.valid[e] = true;
+  return s;
+}
+
+void add(PerfCounters::Sample &total, const PerfCounters::Sample &part) {
+  for (int e = 0; e < PerfCounters::kEventCount; ++e) {
+    total.valid[e] = total.valid[e] && part.valid[e];
+    total.values[e] += part.values[e];
+  }
+  total.seconds += part.seconds;
+}
+
+// Search cost used to rank puzzles: cycles, else CPU time, else wall time
+double cost(const PerfCounters::Sample &s) {
+  if (s.valid[PerfCounters::CYCLES])
+    return s.values[PerfCounters::CYCLES];
+  if (s.valid[PerfCounters::TASK_CLOCK])
+    return s.values[PerfCounters::TASK_CLOCK];
+  return s.seconds;
+}
+
+// Per thousand instructions, or "-" if either count is missing
+std::string perKilo(const PerfCounters::Sample &s, PerfCounters::Event e) {
+  if (!s.valid[e] || !s.valid[PerfCounters::INSTRUCTIONS] ||
+      s.values[PerfCounters::INSTRUCTIONS] <= 0.0)
+    return "-";
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(2)
+     << 1000.0 * s.values[e] / s.values[PerfCounters::INSTRUCTIONS];
+  return ss.str();
+}
+
+std::string count(const PerfCounters::Sample &s, PerfCounters::Event e) {
+  if (!s.valid[e])
+    return "-";
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(0) << s.values[e];
+  return ss.str();
+}
+
+void printRow(const std::string &name, const PerfCounters::Sample &s,
+              size_t puzzles) {
+  std::string ipc = "-";
+  if (s.valid[PerfCounters::CYCLES] && s.valid[PerfCounters::INSTRUCTIONS] &&
+      s.values[PerfCounters::CYCLES] > 0.0) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << s.values[PerfCounters::INSTRUCTIONS] / s.values[PerfCounters::CYCLES];
+    ipc = ss.str();
+  }
+  double n = static_cast<double>(std::max<size_t>(puzzles, 1));
+  std::string cpu = "-";
+  if (s.valid[PerfCounters::TASK_CLOCK]) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << s.values[PerfCounters::TASK_CLOCK] / 1e3 / n;
+    cpu = ss.str();
+  }
+  std::cout << std::left << std::setw(8) << name << std::right
+            << std::setw(15) << count(s, PerfCounters::CYCLES)
+            << std::setw(15) << count(s, PerfCounters::INSTRUCTIONS)
+            << std::setw(6) << ipc << std::setw(10)
+            << perKilo(s, PerfCounters::BRANCH_MISSES) << std::setw(9)
+            << perKilo(s, PerfCounters::L1D_MISSES) << std::setw(9)
+            << perKilo(s, PerfCounters::LLC_MISSES) << std::setw(11) << cpu
+            << std::setw(11) << std::fixed << std::setprecision(2)
+            << s.seconds * 1e6 / n << "\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::string path = argv[1];
+  Solver::Mode mode = Solver::Mode::HYBRID;
+  size_t top = 5;
+  std::string csvPath;
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string opt = argv[i];
+    std::string val = argv[i + 1];
+    if (opt == "--mode") {
+      if (val == "hybrid")
+        mode = Solver::Mode::HYBRID;
+      else if (val == "backtrack")
+        mode = Solver::Mode::BACKTRACK_ONLY;
+      else if (val == "logic")
+        mode = Solver::Mode::LOGIC_ONLY;
+      else if (val == "restarts")
+        mode = Solver::Mode::RANDOM_RESTARTS;
+      else if (val == "sat")
+        mode = Solver::Mode::SAT;
+      else {
+        std::cerr << "Unknown mode: " << val << "\n";
+        return 1;
+      }
+    } else if (opt == "--top") {
+      top = static_cast<size_t>(std::atoi(val.c_str()));
+    } else if (opt == "--csv") {
+      csvPath = val;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  std::vector<std::string> puzzles;
+  if (!BatchSolver::readPuzzleFile(path, puzzles)) {
+    std::cerr << "Error: cannot read " << path << "\n";
+    return 1;
+  }
+
+  PerfCounters counters;
+  std::cout << "Counters : "
+            << (counters.hardwareAvailable() ? "hardware" : "no hardware")
+            << (counters.available(PerfCounters::TASK_CLOCK)
+                    ? ", task clock"
+                    : ", wall clock only");
+  if (!counters.getError().empty())
+    std::cout << " (" << counters.getError() << ")";
+  std::cout << "\n";
+
+  // The logic pass runs on its own first, exactly as solve() would start,
+  // then the search continues from the fixpoint (BACKTRACK_ONLY and SAT
+  // skip the logic pass, LOGIC_ONLY has no search).
+  bool logicPhase = mode != Solver::Mode::BACKTRACK_ONLY &&
+                    mode != Solver::Mode::SAT;
+  Solver::Mode searchMode =
+      mode == Solver::Mode::HYBRID ? Solver::Mode::BACKTRACK_ONLY : mode;
+
+  std::vector<PuzzleProfile> profiles;
+  PerfCounters::Sample totals[kPhases] = {emptyTotal(), emptyTotal()};
+  long long solved = 0;
+  for (size_t i = 0; i < puzzles.size(); ++i) {
+    SudokuBoard board;
+    if (!board.loadFromString(puzzles[i]))
+      continue;
+
+    PerfCounters::Sample start = counters.read();
+    if (logicPhase) {
+      Solver logic(board);
+      logic.setMode(Solver::Mode::LOGIC_ONLY);
+      logic.solveHumanistic();
+    }
+    PerfCounters::Sample afterLogic = counters.read();
+    if (!board.isComplete() && mode != Solver::Mode::LOGIC_ONLY) {
+      Solver search(board);
+      search.setMode(searchMode);
+      search.setSeed(1);
+      search.solve();
+    }
+    PerfCounters::Sample end = counters.read();
+    solved += board.isComplete();
+
+    PuzzleProfile p;
+    p.index = i;
+    p.phase[LOGIC] = PerfCounters::delta(start, afterLogic);
+    p.phase[SEARCH] = PerfCounters::delta(afterLogic, end);
+    add(totals[LOGIC], p.phase[LOGIC]);
+    add(totals[SEARCH], p.phase[SEARCH]);
+    profiles.push_back(p);
+  }
+
+  if (!csvPath.empty()) {
+    std::ofstream out(csvPath);
+    out << "puzzle,phase";
+    for (int e = 0; e < PerfCounters::kEventCount; ++e)
+      out << ","
+          << PerfCounters::eventName(static_cast<PerfCounters::Event>(e));
+    out << ",wall_ns\n";
+    for (const PuzzleProfile &p : profiles) {
+      for (int ph = 0; ph < kPhases; ++ph) {
+        out << p.index << "," << (ph == LOGIC ? "logic" : "search");
+        for (int e = 0; e < PerfCounters::kEventCount; ++e) {
+          out << ",";
+          if (p.phase[ph].valid[e])
+            out << std::fixed << std::setprecision(0) << p.phase[ph].values[e];
+        }
+        out << "," << std::fixed << std::setprecision(0)
+            << p.phase[ph].seconds * 1e9 << "\n";
+      }
+    }
+  }
+
+  PerfCounters::Sample all = emptyTotal();
+  add(all, totals[LOGIC]);
+  add(all, totals[SEARCH]);
+
+  std::cout << "Puzzles  : " << profiles.size() << " (" << solved
+            << " solved)\n\n";
+  std::cout << std::left << std::setw(8) << "Phase" << std::right
+            << std::setw(15) << "cycles" << std::setw(15) << "instructions"
+            << std::setw(6) << "IPC" << std::setw(10) << "brmiss/ki"
+            << std::setw(9) << "L1d/ki" << std::setw(9) << "LLC/ki"
+            << std::setw(11) << "cpu us/pz" << std::setw(11) << "wall us/pz"
+            << "\n";
+  printRow("logic", totals[LOGIC], profiles.size());
+  printRow("search", totals[SEARCH], profiles.size());
+  printRow("total", all, profiles.size());
+
+  std::sort(profiles.begin(), profiles.end(),
+            [](const PuzzleProfile &a, const PuzzleProfile &b) {
+              return cost(a.phase[SEARCH]) > cost(b.phase[SEARCH]);
+            });
+  if (top > 0 && !profiles.empty()) {
+    std::cout << "\nCostliest searches:\n";
+    for (size_t k = 0; k < std::min(top, profiles.size()); ++k) {
+      const PerfCounters::Sample &s = profiles[k].phase[SEARCH];
+      std::cout << "  #" << std::setw(6) << std::left << profiles[k].index
+                << std::right << " cycles " << count(s, PerfCounters::CYCLES)
+                << ", brmiss/ki " << perKilo(s, PerfCounters::BRANCH_MISSES)
+                << ", L1d/ki " << perKilo(s, PerfCounters::L1D_MISSES)
+                << ", " << std::fixed << std::setprecision(1)
+                << s.seconds * 1e6 << " us\n";
+    }
+  }
+  return 0;
+}
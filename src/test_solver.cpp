@@ -1,8 +1,37 @@
+#include "BatchSolver.hpp"
+#include "ConstexprSolver.hpp"
+#include "EngineRace.hpp"
+#include "EngineSelector.hpp"
+#include "Generator.hpp"
+#include "GridSampler.hpp"
+#include "GridVerifier.hpp"
+#include "HintEngine.hpp"
+#include "PerfCounters.hpp"
+#include "Portfolio.hpp"
+#include "PuzzleMiner.hpp"
+#include "PuzzlePool.hpp"
+#include "ResumableSearch.hpp"
+#include "ShardCoordinator.hpp"
+#include "SolutionEnumerator.hpp"
+#include "SolveTrace.hpp"
 #include "Solver.hpp"
 #include "SudokuBoard.hpp"
+#include "SudokuCnf.hpp"
+#include "TranspositionTable.hpp"
+#include "VariantSolver.hpp"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <numeric>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 void printHeader(const std::string &title) {
@@ -11,8 +40,35 @@ void printHeader(const std::string &title) {
   std::cout << "========================================\n";
 }
 
+// Reads the trace at path back: the header must hold start, there must be
+// `records` events, and replaying them on start must give solved.
+bool traceRoundTrips(const std::string &path, const SudokuBoard &start,
+                     const SudokuBoard &solved, uint64_t records) {
+  TraceReader reader;
+  if (!reader.open(path))
+    return false;
+  const uint8_t *initial = reader.getInitialGrid();
+  SudokuBoard replay;
+  for (int i = 0; i < 81; ++i) {
+    if (initial[i] != start.getValue(i / 9, i % 9))
+      return false;
+    replay.placeNumber(i / 9, i % 9, initial[i]);
+  }
+
+  uint64_t read = 0;
+  TraceRecord rec;
+  while (reader.next(rec)) {
+    read++;
+    if (rec.event == TraceEvent::REMOVE)
+      replay.removeNumber(rec.cell / 9, rec.cell % 9);
+    else
+      replay.placeNumber(rec.cell / 9, rec.cell % 9, rec.value);
+  }
+  return read == records && replay.toString() == solved.toString();
+}
+
 void runTest(const std::string &name, const std::vector<std::vector<int>> &grid,
-             Solver::Mode mode) {
+             Solver::Mode mode, const std::string &tracePath = "") {
   printHeader("TEST: " + name);
 
   SudokuBoard board;
@@ -22,17 +78,28 @@ void runTest(const std::string &name, const std::vector<std::vector<int>> &grid,
 
   // Callback to log steps
   solver.setStepCallback([](int r, int c, int n, std::string reason) {
-    // Only print interesting logical steps or first few backtracks to avoid
-    // spam
-    if (reason.find("Backtrack") == std::string::npos || rand() % 20 == 0) {
+    // Only print interesting logical steps and a sample of the per-node
+    // search steps (backtracks, "Backtrack Try", "Random Try") to avoid spam
+    bool searchStep = reason.find("Backtrack") != std::string::npos ||
+                      reason.find("Try") != std::string::npos;
+    if (!searchStep || rand() % 20 == 0) {
       std::cout << "[STEP] (" << r << "," << c << ") -> " << n << " : "
                 << reason << "\n";
     }
   });
 
+  TraceWriter trace;
+  if (!tracePath.empty()) {
+    if (trace.open(tracePath, board))
+      solver.setTraceWriter(&trace);
+    else
+      std::cout << "Warning: could not open trace file " << tracePath << "\n";
+  }
+
   std::cout << "Difficulty Estimate: "
             << solver.difficultyToString(solver.estimateDifficulty()) << "\n";
 
+  SudokuBoard start = board;
   bool solved = solver.solve();
 
   if (solved) {
@@ -45,6 +112,18 @@ void runTest(const std::string &name, const std::vector<std::vector<int>> &grid,
   std::cout << "  Logic Moves : " << solver.getLogicCount() << "\n";
   std::cout << "  Backtracks  : " << solver.getBacktrackCount() << "\n";
   std::cout << "  Recursions  : " << solver.getRecursionCount() << "\n";
+  if (mode == Solver::Mode::RANDOM_RESTARTS)
+    std::cout << "  Restarts    : " << solver.getRestartCount()
+              << " (winning seed " << solver.getWinningSeed() << ")\n";
+  if (trace.isOpen()) {
+    std::cout << "  Trace Events: " << trace.getRecordCount() << " -> "
+              << tracePath << "\n";
+    if (!trace.close() ||
+        !traceRoundTrips(tracePath, start, board, trace.getRecordCount())) {
+      std::cout << "ERROR: trace does not read back as written\n";
+      exit(1);
+    }
+  }
 
   if (solved && !board.isComplete()) {
     std::cout << "ERROR: solver returned true but board is not complete!\n";
@@ -52,8 +131,1309 @@ void runTest(const std::string &name, const std::vector<std::vector<int>> &grid,
   }
 }
 
+// Budgets follow the Luby sequence or grow geometrically; with a tiny base
+// budget the hard grid needs restarts, and a fixed seed reproduces the
+// winning run exactly.
+void runRestartScheduleTest(const std::vector<std::vector<int>> &hardGrid) {
+  printHeader("TEST: Restart Schedules");
+
+  SudokuBoard board;
+  board.loadBoard(hardGrid);
+  Solver solver(board);
+  solver.setRestartSchedule(Solver::RestartSchedule::LUBY, 10);
+  const long long luby[] = {1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8};
+  bool lubyOk = true;
+  for (int i = 0; i < 15; ++i)
+    lubyOk = lubyOk && solver.restartBudget(i) == 10 * luby[i];
+  solver.setRestartSchedule(Solver::RestartSchedule::GEOMETRIC, 100, 1.5);
+  const long long geometric[] = {100, 150, 225, 337, 506};
+  bool geometricOk = true;
+  for (int i = 0; i < 5; ++i)
+    geometricOk = geometricOk && solver.restartBudget(i) == geometric[i];
+
+  struct Run {
+    bool solved = false;
+    unsigned int winningSeed = 0;
+    int restarts = 0;
+    std::string solution;
+  };
+  auto runSeeded = [&](unsigned int seed) {
+    SudokuBoard b;
+    b.loadBoard(hardGrid);
+    Solver s(b);
+    s.setMode(Solver::Mode::RANDOM_RESTARTS);
+    s.setRestartSchedule(Solver::RestartSchedule::LUBY, 2);
+    s.setSeed(seed);
+    Run run;
+    run.solved = s.solve() && b.isComplete();
+    run.winningSeed = s.getWinningSeed();
+    run.restarts = s.getRestartCount();
+    run.solution = b.toString();
+    return run;
+  };
+  Run first = runSeeded(7), second = runSeeded(7);
+  std::cout << "Seed 7, base budget 2: " << first.restarts
+            << " restarts, winning seed " << first.winningSeed << "\n";
+
+  if (!lubyOk || !geometricOk || !first.solved || first.restarts == 0 ||
+      first.winningSeed != 7u + static_cast<unsigned int>(first.restarts) ||
+      second.restarts != first.restarts ||
+      second.winningSeed != first.winningSeed ||
+      second.solution != first.solution) {
+    std::cout << "[FAILURE] Restart schedule or seeding is off.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Luby and geometric budgets, reproducible "
+               "restarts.\n";
+}
+
+// The hard grid in HYBRID writes 540 events; reading the file back must
+// give the starting board, the same count, and replay to the solution.
+void runTraceTest(const std::vector<std::vector<int>> &hardGrid) {
+  printHeader("TEST: Trace Round Trip");
+
+  SudokuBoard board;
+  board.loadBoard(hardGrid);
+  SudokuBoard start = board;
+  const std::string path = "trace_test.bin";
+  TraceWriter trace;
+  Solver solver(board);
+  bool opened = trace.open(path, board);
+  solver.setTraceWriter(&trace);
+  bool solved = solver.solve();
+  solver.setTraceWriter(nullptr);
+  uint64_t records = trace.getRecordCount();
+  bool written = trace.close();
+  bool readBack = traceRoundTrips(path, start, board, records);
+  std::remove(path.c_str());
+
+  std::cout << "Events: " << records << " written\n";
+  if (!opened || !solved || !written || records != 540 || !readBack) {
+    std::cout << "[FAILURE] Trace does not read back as written.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Initial board, 540 events and replay match.\n";
+}
+
+void runBatchTest(const std::vector<std::vector<std::vector<int>>> &grids) {
+  printHeader("TEST: Batch (Scalar vs Lockstep)");
+
+  std::vector<std::string> puzzles;
+  for (const auto &grid : grids) {
+    SudokuBoard board;
+    board.loadBoard(grid);
+    puzzles.push_back(board.toString());
+  }
+
+  BatchSolver scalar(BatchSolver::Engine::SCALAR);
+  BatchSolver lockstep(BatchSolver::Engine::LOCKSTEP);
+  std::vector<BatchSolver::Result> a = scalar.solveAll(puzzles);
+  std::vector<BatchSolver::Result> b = lockstep.solveAll(puzzles);
+
+  for (size_t i = 0; i < puzzles.size(); ++i) {
+    if (!a[i].solved || !b[i].solved || a[i].solution != b[i].solution) {
+      std::cout << "ERROR: engines disagree on puzzle " << i << "\n";
+      exit(1);
+    }
+  }
+  std::cout << "[SUCCESS] " << puzzles.size() << " puzzles, "
+            << lockstep.getStats().propagated << " by propagation, "
+            << lockstep.getStats().fallback << " by fallback\n";
+}
+
+template <class Rules>
+bool variantUnitsValid(const VariantBoard<Rules> &board) {
+  const Rules &rules = board.getRules();
+  for (int u = 0; u < Rules::kUnitCount; ++u) {
+    int seen = 0;
+    for (int cell : rules.unit(u)) {
+      int v = board.getValue(cell);
+      if (v == 0 || (seen & (1 << v)))
+        return false;
+      seen |= (1 << v);
+    }
+  }
+  return true;
+}
+
+template <class Rules>
+void runVariantTest(const std::string &name, VariantBoard<Rules> &board,
+                    Solver::Mode mode = Solver::Mode::HYBRID) {
+  VariantSolver<Rules> solver(board);
+  solver.setMode(mode);
+  bool solved = solver.solve();
+  std::cout << name << ": " << (solved ? "solved" : "FAILED")
+            << " (logic " << solver.getLogicCount() << ", backtracks "
+            << solver.getBacktrackCount() << ")\n";
+  if (!solved || !variantUnitsValid(board)) {
+    std::cout << "ERROR: invalid " << name << " solution\n";
+    exit(1);
+  }
+}
+
+// Every third cell of a solved variant board (shifted by one per row), as
+// givens for a new puzzle.
+template <class Rules>
+std::string thinnedGivens(const VariantBoard<Rules> &solved) {
+  std::string text = solved.toString();
+  for (int i = 0; i < 81; ++i) {
+    if ((i + i / 9) % 3 != 0)
+      text[i] = '0';
+  }
+  return text;
+}
+
+// VariantSolver<ClassicRules> must agree with Solver on the classic
+// fixtures in both search modes, and both must reject the hard grid with a
+// wrong (but unit-consistent) digit added.
+void runClassicRulesTest(const std::vector<std::vector<int>> &easyGrid,
+                         const std::vector<std::vector<int>> &hardGrid) {
+  SudokuBoard easy, hard;
+  easy.loadBoard(easyGrid);
+  hard.loadBoard(hardGrid);
+  SudokuBoard hardSolved = hard;
+  Solver(hardSolved).solve();
+  SudokuBoard wrong = hard;
+  for (int i = 0; i < 81; ++i) {
+    int r = i / 9, c = i % 9;
+    if (wrong.getValue(r, c) != 0)
+      continue;
+    for (int n = 1; n <= 9; ++n) {
+      if (n != hardSolved.getValue(r, c) && wrong.isValid(r, c, n)) {
+        wrong.placeNumber(r, c, n);
+        break;
+      }
+    }
+    if (wrong.getValue(r, c) != 0)
+      break;
+  }
+
+  for (Solver::Mode mode :
+       {Solver::Mode::HYBRID, Solver::Mode::BACKTRACK_ONLY}) {
+    for (const SudokuBoard *start : {&easy, &hard, &wrong}) {
+      SudokuBoard board = *start;
+      Solver classic(board);
+      classic.setMode(mode);
+      bool classicSolved = classic.solve();
+
+      VariantBoard<ClassicRules> variantBoard;
+      variantBoard.loadFromString(start->toString());
+      VariantSolver<ClassicRules> variant(variantBoard);
+      variant.setMode(mode);
+      bool variantSolved = variant.solve();
+
+      bool expected = start != &wrong;
+      if (classicSolved != expected || variantSolved != expected ||
+          (expected && variantBoard.toString() != board.toString())) {
+        std::cout << "ERROR: ClassicRules disagrees with Solver\n";
+        exit(1);
+      }
+    }
+  }
+  std::cout << "Classic rules: easy, hard and unsolvable grids agree with "
+               "Solver in both modes\n";
+}
+
+void runVariantTests(const std::vector<std::vector<int>> &easyGrid,
+                     const std::vector<std::vector<int>> &hardGrid) {
+  printHeader("TEST: Variants (X, Jigsaw, Killer)");
+
+  runClassicRulesTest(easyGrid, hardGrid);
+
+  VariantBoard<DiagonalRules> xBoard;
+  runVariantTest("X-Sudoku", xBoard);
+  VariantBoard<DiagonalRules> xPuzzle;
+  xPuzzle.loadFromString(thinnedGivens(xBoard));
+  runVariantTest("X-Sudoku with givens", xPuzzle);
+  VariantBoard<DiagonalRules> xSat;
+  xSat.loadFromString(thinnedGivens(xBoard));
+  runVariantTest("X-Sudoku with givens (SAT)", xSat, Solver::Mode::SAT);
+
+  // The hard grid's only classic solution breaks a diagonal, so under X
+  // rules it has none; only the search can tell.
+  SudokuBoard hard;
+  hard.loadBoard(hardGrid);
+  VariantBoard<DiagonalRules> xHard;
+  xHard.loadFromString(hard.toString());
+  VariantSolver<DiagonalRules> xHardSolver(xHard);
+  if (xHardSolver.solve()) {
+    std::cout << "ERROR: unsolvable X-Sudoku reported solved\n";
+    exit(1);
+  }
+  VariantBoard<DiagonalRules> xHardSat;
+  xHardSat.loadFromString(hard.toString());
+  VariantSolver<DiagonalRules> xHardSatSolver(xHardSat);
+  xHardSatSolver.setMode(Solver::Mode::SAT);
+  if (xHardSatSolver.solve()) {
+    std::cout << "ERROR: unsolvable X-Sudoku reported solved by SAT\n";
+    exit(1);
+  }
+  std::cout << "X-Sudoku from the hard grid: unsolvable ("
+            << xHardSolver.getBacktrackCount() << " backtracks, "
+            << xHardSatSolver.getBacktrackCount() << " SAT conflicts)\n";
+
+  // Broken anti-diagonals as regions: irregular, but still solvable.
+  std::array<int, 81> regions{};
+  for (int cell = 0; cell < 81; ++cell)
+    regions[cell] = (cell / 9 + cell % 9) % 9;
+  VariantBoard<JigsawRules> jigsawBoard{JigsawRules(regions)};
+  runVariantTest("Jigsaw", jigsawBoard);
+  VariantBoard<JigsawRules> jigsawPuzzle{JigsawRules(regions)};
+  jigsawPuzzle.loadFromString(thinnedGivens(jigsawBoard));
+  runVariantTest("Jigsaw with givens", jigsawPuzzle);
+  VariantBoard<JigsawRules> jigsawSat{JigsawRules(regions)};
+  jigsawSat.loadFromString(thinnedGivens(jigsawBoard));
+  runVariantTest("Jigsaw with givens (SAT)", jigsawSat, Solver::Mode::SAT);
+
+  // Killer with no givens: horizontal domino cages taken from a known
+  // classic solution.
+  SudokuBoard solvedBoard;
+  solvedBoard.loadBoard(easyGrid);
+  Solver classic(solvedBoard);
+  classic.solve();
+
+  std::vector<KillerRules::Cage> cages;
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; c += 2) {
+      KillerRules::Cage cage;
+      for (int k = c; k < std::min(c + 2, 9); ++k) {
+        cage.cells.push_back(r * 9 + k);
+        cage.sum += solvedBoard.getValue(r, k);
+      }
+      cages.push_back(cage);
+    }
+  }
+  VariantBoard<KillerRules> killerBoard{KillerRules(cages)};
+  runVariantTest("Killer", killerBoard);
+  VariantBoard<KillerRules> killerPuzzle{KillerRules(cages)};
+  killerPuzzle.loadFromString(thinnedGivens(killerBoard));
+  runVariantTest("Killer with givens", killerPuzzle);
+
+  for (const VariantBoard<KillerRules> *board :
+       {&killerBoard, &killerPuzzle}) {
+    for (const KillerRules::Cage &cage : cages) {
+      int sum = 0;
+      for (int cell : cage.cells)
+        sum += board->getValue(cell);
+      if (sum != cage.sum) {
+        std::cout << "ERROR: killer cage sum violated\n";
+        exit(1);
+      }
+    }
+  }
+  std::cout << "[SUCCESS] Classic rules match Solver; X, Jigsaw and Killer "
+               "solved with and without givens, X and Jigsaw also by SAT.\n";
+}
+
+void runPortfolioTest(const std::vector<std::vector<int>> &grid) {
+  printHeader("TEST: Portfolio Race");
+
+  SudokuBoard board;
+  board.loadBoard(grid);
+  Portfolio portfolio(Portfolio::defaultConfigs(4));
+  Portfolio::Result result = portfolio.solve(board);
+
+  if (!result.solved || !board.isComplete()) {
+    std::cout << "[FAILURE] Portfolio did not solve the puzzle.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Winner: " << result.winner << " ("
+            << result.winnerRecursions << " recursions, " << result.seconds
+            << "s)\n";
+}
+
+void runLargeSatTest(int boxSize) {
+  int n = boxSize * boxSize;
+  printHeader("TEST: SAT " + std::to_string(n) + "x" + std::to_string(n));
+
+  // A third of the cells of the shifted-pattern solution as givens.
+  std::vector<int> grid(n * n, 0);
+  for (int r = 0; r < n; ++r) {
+    for (int c = 0; c < n; ++c) {
+      if ((r + c) % 3 == 0)
+        grid[r * n + c] = (r * boxSize + r / boxSize + c) % n + 1;
+    }
+  }
+  std::vector<int> givens = grid;
+
+  CdclSolver::Result result = SudokuCnf::solveGrid(boxSize, grid);
+  bool valid = result == CdclSolver::Result::SATISFIABLE;
+  for (int i = 0; valid && i < n; ++i) {
+    std::vector<int> row(n + 1, 0), col(n + 1, 0), box(n + 1, 0);
+    for (int k = 0; k < n; ++k) {
+      int br = (i / boxSize) * boxSize + k / boxSize;
+      int bc = (i % boxSize) * boxSize + k % boxSize;
+      if (row[grid[i * n + k]]++ || col[grid[k * n + i]]++ ||
+          box[grid[br * n + bc]]++)
+        valid = false;
+    }
+  }
+  for (int i = 0; valid && i < n * n; ++i)
+    valid = givens[i] == 0 || grid[i] == givens[i];
+
+  if (!valid) {
+    std::cout << "[FAILURE] Invalid " << n << "x" << n << " solution.\n";
+    exit(1);
+  }
+
+  // No unit repeats a digit, but the first row takes 2..n and the first
+  // column's last cell takes 1, leaving the corner no candidate.
+  std::vector<int> dead(n * n, 0);
+  for (int c = 1; c < n; ++c)
+    dead[c] = c + 1;
+  dead[(n - 1) * n] = 1;
+  if (SudokuCnf::solveGrid(boxSize, dead) !=
+      CdclSolver::Result::UNSATISFIABLE) {
+    std::cout << "[FAILURE] Unsolvable " << n << "x" << n
+              << " grid not reported UNSAT.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Solved and verified; unsolvable grid rejected.\n";
+}
+
+// Copies compare equal; a placed digit or a different set of givens does not.
+void runBoardCopyTest(const std::vector<std::vector<int>> &grid) {
+  printHeader("TEST: Board Copy / Compare");
+
+  SudokuBoard board;
+  board.loadBoard(grid);
+  SudokuBoard copy = board;
+  bool ok = copy == board && copy.getHash() == board.getHash();
+
+  int cell = 0;
+  while (board.getValue(cell / 9, cell % 9) != 0)
+    cell++;
+  for (int num = 1; num <= 9; ++num) {
+    if (copy.isValid(cell / 9, cell % 9, num)) {
+      copy.placeNumber(cell / 9, cell % 9, num);
+      break;
+    }
+  }
+  ok = ok && copy != board;
+  copy.removeNumber(cell / 9, cell % 9);
+  ok = ok && copy == board;
+
+  // Same digits, but none of them given.
+  SudokuBoard loose;
+  for (int i = 0; i < 9; ++i) {
+    for (int j = 0; j < 9; ++j)
+      loose.placeNumber(i, j, grid[i][j]);
+  }
+  ok = ok && loose.getHash() == board.getHash() && loose != board;
+
+  std::cout << "sizeof(SudokuBoard) = " << sizeof(SudokuBoard) << " bytes\n";
+  if (!ok) {
+    std::cout << "[FAILURE] Board copy or comparison is wrong.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Copies compare correctly.\n";
+}
+
+// The easy fixture, parsed and solved by the compiler.
+constexpr SudokuBoard kEasyPuzzle = ConstexprSolver::parse("000260701"
+                                                           "680070090"
+                                                           "190004500"
+                                                           "820100040"
+                                                           "004602900"
+                                                           "050003028"
+                                                           "009300074"
+                                                           "040050036"
+                                                           "703018000");
+static_assert(ConstexprSolver::countSolutions(kEasyPuzzle, 2) == 1,
+              "the easy fixture must have exactly one solution");
+constexpr SudokuBoard kEasySolution = ConstexprSolver::solved(kEasyPuzzle);
+static_assert(kEasySolution.isComplete() &&
+                  kEasySolution.getValue(0, 0) == 4,
+              "the easy fixture solves at compile time");
+
+// Compile-time boards must be the ones run-time code builds, and the
+// constexpr search must agree with Solver.
+void runConstexprTest(const std::vector<std::vector<int>> &easyGrid,
+                      const std::vector<std::vector<int>> &openGrid) {
+  printHeader("TEST: Constexpr Solver");
+
+  SudokuBoard loaded;
+  loaded.loadBoard(easyGrid);
+  bool ok = loaded == kEasyPuzzle && loaded.getHash() == kEasyPuzzle.getHash();
+
+  Solver solver(loaded);
+  ok = ok && solver.solve() && loaded == kEasySolution;
+
+  SudokuBoard open;
+  open.loadBoard(openGrid);
+  SudokuBoard counted = open;
+  Solver counter(counted);
+  long long expected = counter.countSolutions(50);
+  long long found = ConstexprSolver::countSolutions(open, 50);
+  SudokuBoard solvedOpen = open;
+  ok = ok && found == expected &&
+       ConstexprSolver::solve(solvedOpen) && solvedOpen.isComplete();
+
+  // Every peer shares a unit, and no cell is its own peer.
+  for (int cell = 0; cell < 81; ++cell) {
+    for (int other : kSudokuTables.peers[cell]) {
+      const uint8_t *a = kSudokuTables.unitsOf[cell];
+      const uint8_t *b = kSudokuTables.unitsOf[other];
+      ok = ok && other != cell &&
+           (a[0] == b[0] || a[1] == b[1] || a[2] == b[2]);
+    }
+  }
+
+  std::cout << "Open grid: " << found << " solutions (Solver: " << expected
+            << ")\n";
+  if (!ok) {
+    std::cout << "[FAILURE] Compile-time and run-time results differ.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Constexpr boards and search match run time.\n";
+}
+
+// Counts solutions with and without a transposition table; both must agree.
+// A second count on the warm table should be answered from the cache.
+void runCountTest(const std::string &name,
+                  const std::vector<std::vector<int>> &grid,
+                  long long expected) {
+  printHeader("TEST: Count " + name);
+
+  SudokuBoard board;
+  board.loadBoard(grid);
+  uint64_t hashBefore = board.getHash();
+  Solver plain(board);
+  long long plainCount = plain.countSolutions();
+  long long plainNodes = plain.getRecursionCount();
+
+  TranspositionTable table;
+  Solver cached(board);
+  cached.setTranspositionTable(&table);
+  long long cachedCount = cached.countSolutions();
+  long long warmCount = cached.countSolutions();
+
+  std::cout << "Solutions: " << plainCount << " (" << plainNodes
+            << " nodes, warm table: " << cached.getRecursionCount()
+            << " nodes, " << table.getHits() << " hits)\n";
+  if (plainCount != cachedCount || warmCount != plainCount ||
+      (expected >= 0 && plainCount != expected) ||
+      board.getHash() != hashBefore) {
+    std::cout << "[FAILURE] Solution counts disagree.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Counts match.\n";
+}
+
+// A minimal puzzle is unique and every single clue is needed.
+void runMinimalTest() {
+  printHeader("TEST: Minimal Generation");
+
+  SudokuBoard board;
+  Generator generator;
+  generator.generate(board, Generator::Difficulty::MINIMAL);
+
+  std::vector<std::vector<int>> grid(9, std::vector<int>(9));
+  int clues = 0;
+  for (int r = 0; r < 9; ++r) {
+    for (int c = 0; c < 9; ++c) {
+      grid[r][c] = board.getValue(r, c);
+      clues += grid[r][c] != 0;
+    }
+  }
+  std::cout << clues << " clues, " << generator.getLastCheckNodes()
+            << " check nodes\n";
+
+  bool ok = Solver(board).countSolutions(2) == 1;
+  for (int cell = 0; ok && cell < 81; ++cell) {
+    int r = cell / 9, c = cell % 9;
+    if (grid[r][c] == 0)
+      continue;
+    std::vector<std::vector<int>> reduced = grid;
+    reduced[r][c] = 0;
+    SudokuBoard probe;
+    probe.loadBoard(reduced);
+    ok = Solver(probe).countSolutions(2) == 2;
+  }
+  if (!ok) {
+    std::cout << "[FAILURE] Puzzle is not unique and minimal.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Unique and minimal.\n";
+}
+
+// Streams every solution through a deliberately small queue and checks the
+// result against the sequential counter and the count-only path.
+void runEnumerateTest(const std::vector<std::vector<int>> &grid) {
+  printHeader("TEST: Parallel Enumeration");
+
+  SudokuBoard board;
+  board.loadBoard(grid);
+  long long expected = Solver(board).countSolutions();
+
+  SolutionEnumerator enumerator(4);
+  enumerator.setQueueCapacity(8);
+  std::set<std::string> seen;
+  bool allValid = true;
+  SolutionEnumerator::Result streamed =
+      enumerator.enumerate(board, [&](const SudokuBoard &solution) {
+        allValid = allValid && solution.isComplete();
+        seen.insert(solution.toString());
+        return true;
+      });
+  SolutionEnumerator::Result counted = enumerator.count(board);
+
+  long long taken = 0;
+  SolutionEnumerator::Result stopped = enumerator.enumerate(
+      board, [&](const SudokuBoard &) { return ++taken < 10; });
+
+  std::cout << "Solutions: " << streamed.solutions << " streamed in "
+            << streamed.seconds << "s, " << counted.solutions
+            << " counted in " << counted.seconds << "s\n";
+  if (!allValid || !streamed.complete || !counted.complete ||
+      streamed.solutions != expected ||
+      static_cast<long long>(seen.size()) != expected ||
+      counted.solutions != expected || stopped.complete ||
+      stopped.solutions != 10) {
+    std::cout << "[FAILURE] Enumeration disagrees with the sequential count ("
+              << expected << ").\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] All solutions distinct and accounted for.\n";
+}
+
+// Interrupts a full count and a randomized first-solution search every few
+// nodes, reloading the checkpoint into a fresh search each time; node counts,
+// solution counts and the solution found must match an uninterrupted run.
+void runResumeTest(const std::vector<std::vector<int>> &grid) {
+  printHeader("TEST: Checkpoint and Resume");
+
+  SudokuBoard board;
+  board.loadBoard(grid);
+  const std::string path = "resume_test.ckpt";
+  bool ok = true;
+
+  struct Case {
+    unsigned int seed;
+    long long limit;
+    long long budget;
+  };
+  for (const Case &run : {Case{0, 0, 300}, Case{42, 1, 5}}) {
+    ResumableSearch whole;
+    whole.start(board, run.limit, run.seed);
+    whole.run();
+
+    ResumableSearch first;
+    first.start(board, run.limit, run.seed);
+    first.setCheckpointFile(path, 0);
+    int pieces = 1;
+    bool done = first.run(run.budget);
+    while (!done && ok) {
+      ResumableSearch resumed;
+      ok = resumed.loadCheckpoint(path);
+      resumed.setCheckpointFile(path, 0);
+      done = resumed.run(run.budget);
+      pieces++;
+      if (done)
+        ok = ok && resumed.getNodes() == whole.getNodes() &&
+             resumed.getSolutions() == whole.getSolutions() &&
+             resumed.getBoard() == whole.getBoard();
+    }
+    std::cout << "Seed " << run.seed << ", limit " << run.limit << ": "
+              << whole.getSolutions() << " solution(s), " << whole.getNodes()
+              << " nodes, resumed in " << pieces << " pieces\n";
+  }
+  std::remove(path.c_str());
+
+  // Splitting a snapshot: a second solver takes the untried digits of the
+  // shallowest frame that has any, the first keeps the branch it is in.
+  // Together they must count every solution exactly once.
+  SudokuBoard ownerBoard = board, thiefBoard = board;
+  Solver owner(ownerBoard), thief(thiefBoard);
+  Solver::SearchState ownerState, thiefState;
+  Solver::SearchOptions options;
+  options.maxNodes = 200;
+  owner.search(ownerState, options);
+  int split = 0;
+  while (split < ownerState.depth && !ownerState.frames[split].remaining)
+    split++;
+  ok = ok && split < ownerState.depth && !ownerState.finished;
+  for (int k = 0; ok && k <= split; ++k) {
+    Solver::SearchFrame &f = thiefState.frames[k];
+    f = ownerState.frames[k];
+    if (k < split) {
+      f.remaining = 0; // Path to the stolen frame, only unwound
+      thiefBoard.placeNumber(f.cell / 9, f.cell % 9, f.placed);
+    } else {
+      f.placed = 0;
+      ownerState.frames[k].remaining = 0;
+    }
+  }
+  thiefState.depth = split + 1;
+  thiefState.expand = false;
+  options.maxNodes = 0;
+  owner.search(ownerState, options);
+  thief.search(thiefState, options);
+  SudokuBoard counted = board;
+  long long total = Solver(counted).countSolutions();
+  std::cout << "Split search: " << ownerState.solutions << " + "
+            << thiefState.solutions << " of " << total << " solutions\n";
+  ok = ok && ownerState.solutions + thiefState.solutions == total &&
+       ownerBoard == board && thiefBoard == board;
+
+  ok = ok && !ResumableSearch().loadCheckpoint(path);
+  if (!ok) {
+    std::cout << "[FAILURE] Resumed search diverged from the full run.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Resumed runs match exactly.\n";
+}
+
+// Every sampled grid must be valid, the same seed must repeat the sequence,
+// and bulk sampling should run at millions of grids per second.
+void runSamplerTest() {
+  printHeader("TEST: Grid Sampler");
+
+  const int count = 1000000;
+  GridSampler sampler(12345);
+  uint8_t grid[81], again[81];
+  bool valid = true, repeatable = true;
+  std::set<std::string> distinct;
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < count; ++i) {
+    sampler.sample(grid);
+    if (i % 100 != 0)
+      continue;
+    uint16_t rows[9] = {0}, cols[9] = {0}, boxes[9] = {0};
+    for (int cell = 0; cell < 81; ++cell) {
+      int r = cell / 9, c = cell % 9;
+      uint16_t bit = static_cast<uint16_t>(1 << grid[cell]);
+      rows[r] |= bit;
+      cols[c] |= bit;
+      boxes[(r / 3) * 3 + c / 3] |= bit;
+    }
+    for (int k = 0; k < 9; ++k)
+      valid = valid && rows[k] == 0x3FE && cols[k] == 0x3FE &&
+              boxes[k] == 0x3FE;
+    distinct.insert(std::string(grid, grid + 81));
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  GridSampler first(99), second(99);
+  for (int i = 0; i < 100; ++i) {
+    first.sample(grid);
+    second.sample(again);
+    repeatable = repeatable && std::equal(grid, grid + 81, again);
+  }
+
+  std::cout << count << " grids in " << seconds << "s ("
+            << static_cast<long long>(count / seconds) << " grids/s), "
+            << distinct.size() << " distinct of " << count / 100
+            << " checked\n";
+  if (!valid || !repeatable ||
+      distinct.size() != static_cast<size_t>(count / 100)) {
+    std::cout << "[FAILURE] Invalid, repeated or unrepeatable grids.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] All checked grids valid and distinct.\n";
+}
+
+// The heatmap must agree with the solver's own counters, and the digits left
+// on the board by guesses must equal placements minus take-backs.
+void runHeatmapTest(const std::vector<std::vector<int>> &grid) {
+  printHeader("TEST: Search Heatmap");
+
+  SudokuBoard plain, watched;
+  plain.loadBoard(grid);
+  watched.loadBoard(grid);
+  Solver baseline(plain);
+  baseline.setMode(Solver::Mode::BACKTRACK_ONLY);
+  auto start = std::chrono::high_resolution_clock::now();
+  baseline.solve();
+  double plainSeconds = std::chrono::duration<double>(
+                            std::chrono::high_resolution_clock::now() - start)
+                            .count();
+
+  Solver::Heatmap heatmap;
+  Solver solver(watched);
+  solver.setMode(Solver::Mode::BACKTRACK_ONLY);
+  solver.setHeatmap(&heatmap);
+  start = std::chrono::high_resolution_clock::now();
+  bool solved = solver.solve();
+  double heatSeconds = std::chrono::duration<double>(
+                           std::chrono::high_resolution_clock::now() - start)
+                           .count();
+
+  long long branches = 0, backtracks = 0, changes = 0;
+  int guessed = 0, hottest = 0;
+  for (int cell = 0; cell < 81; ++cell) {
+    branches += heatmap.branches[cell];
+    backtracks += heatmap.backtracks[cell];
+    changes += heatmap.changes[cell];
+    guessed += watched.isFixed(cell / 9, cell % 9) ? 0 : 1;
+    if (heatmap.branches[cell] > heatmap.branches[hottest])
+      hottest = cell;
+  }
+  std::cout << "Nodes: " << heatmap.nodes << ", backtracks: " << backtracks
+            << ", hottest cell r" << hottest / 9 + 1 << "c" << hottest % 9 + 1
+            << " (" << heatmap.branches[hottest] << " branches)\n";
+  std::cout << "Time: " << plainSeconds << "s plain, " << heatSeconds
+            << "s with heatmap\n";
+  if (!solved || !(watched == plain) ||
+      heatmap.nodes != solver.getRecursionCount() ||
+      backtracks != solver.getBacktrackCount() ||
+      changes - backtracks != guessed || branches < guessed) {
+    std::cout << "[FAILURE] Heatmap disagrees with the solver counters.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Heatmap matches the search.\n";
+}
+
+// Producers fill each level to the high watermark, pops drain it, and a
+// drain to the low watermark triggers a refill. The saved pool must load
+// back into a pool that was never started.
+void runPoolTest() {
+  printHeader("TEST: Puzzle Pool");
+
+  const std::string path = "pool_test.txt";
+  const auto easy = Generator::Difficulty::EASY;
+  const auto medium = Generator::Difficulty::MEDIUM;
+  PuzzlePool::Options options;
+  options.lowWatermark = 2;
+  options.highWatermark = 5;
+  options.producers = 2;
+  options.levels = {easy, medium};
+
+  auto waitFor = [](const std::function<bool()> &done) {
+    for (int i = 0; i < 500 && !done(); ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return done();
+  };
+
+  bool ok = true;
+  {
+    PuzzlePool pool(options);
+    pool.start();
+    ok = waitFor(
+        [&]() { return pool.size(easy) == 5 && pool.size(medium) == 5; });
+
+    SudokuBoard board;
+    for (int i = 0; i < 3 && ok; ++i) {
+      auto start = std::chrono::high_resolution_clock::now();
+      ok = pool.tryPop(easy, board);
+      double micros = std::chrono::duration<double, std::micro>(
+                          std::chrono::high_resolution_clock::now() - start)
+                          .count();
+      SudokuBoard solved = board;
+      ok = ok && Solver(solved).solve() && solved.isComplete();
+      std::cout << "Pop " << i + 1 << ": " << micros << " us\n";
+    }
+    ok = ok && waitFor([&]() { return pool.size(easy) == 5; });
+    std::cout << "Generated " << pool.getGenerated() << " puzzles\n";
+    pool.stop();
+    ok = ok && pool.getGenerated() == 13 && pool.save(path);
+  }
+
+  PuzzlePool reloaded(options);
+  SudokuBoard board;
+  ok = ok && reloaded.load(path) && reloaded.size(easy) == 5 &&
+       reloaded.size(medium) == 5 && reloaded.pop(medium, board) &&
+       reloaded.size(medium) == 4 &&
+       !reloaded.tryPop(Generator::Difficulty::HARD, board);
+  std::remove(path.c_str());
+
+  if (!ok) {
+    std::cout << "[FAILURE] Pool did not fill, drain and reload as set.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Pool refills between watermarks and persists.\n";
+}
+
+// Sampled grids, 3 in every 40 corrupted (one per kind of fault); the lane
+// verifier must agree with the one-grid reference on every verdict, whether
+// it reads strings or packed 81-byte records.
+void runVerifierTest() {
+  printHeader("TEST: Grid Verifier");
+
+  const int count = 200000;
+  GridSampler sampler(7);
+  std::vector<std::string> solutions(count), puzzles(count);
+  uint8_t grid[81];
+  for (int i = 0; i < count; ++i) {
+    sampler.sample(grid);
+    std::string &s = solutions[i];
+    s.resize(81);
+    for (int c = 0; c < 81; ++c)
+      s[c] = static_cast<char>('0' + grid[c]);
+    puzzles[i] = s;
+    for (int c = 0; c < 81; c += 2)
+      puzzles[i][c] = '0';
+
+    if (i % 40 == 10)
+      std::swap(s[0], s[1]); // Row still fine, columns and box broken
+    else if (i % 40 == 20)
+      puzzles[i][3] = puzzles[i][3] == '9' ? '1' : puzzles[i][3] + 1;
+    else if (i % 40 == 30)
+      s[40] = '0';
+  }
+
+  GridVerifier verifier;
+  std::vector<GridVerifier::Verdict> verdicts =
+      verifier.verify(solutions, puzzles);
+  const GridVerifier::Stats &stats = verifier.getStats();
+
+  std::string packedSolutions, packedPuzzles;
+  for (int i = 0; i < count; ++i) {
+    packedSolutions += solutions[i];
+    packedPuzzles += puzzles[i];
+  }
+  GridVerifier packedVerifier;
+  bool agree = packedVerifier.verify(packedSolutions.data(), count,
+                                     packedPuzzles.data()) == verdicts;
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < count; ++i)
+    agree = agree &&
+            verdicts[i] == GridVerifier::verifyOne(solutions[i], &puzzles[i]);
+  double scalarSeconds = std::chrono::duration<double>(
+                             std::chrono::high_resolution_clock::now() - start)
+                             .count();
+
+  std::cout << stats.valid << " valid, " << stats.brokenUnit << " broken, "
+            << stats.givenChanged << " given changed, " << stats.malformed
+            << " malformed\n";
+  std::cout << "Lanes: " << static_cast<long long>(count / stats.seconds)
+            << " grids/s, one at a time: "
+            << static_cast<long long>(count / scalarSeconds) << " grids/s\n";
+  if (!agree || stats.brokenUnit != count / 40 ||
+      stats.givenChanged != count / 40 || stats.malformed != count / 40) {
+    std::cout << "[FAILURE] Verdicts disagree with the reference.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Every corrupted grid caught.\n";
+}
+
+// Forty puzzles in eight shards over three worker processes. One worker is
+// killed on its first attempt and retried; another shard fails every time
+// and is given up. Everything else must match an in-process run, in order.
+// A portfolio run over processes must report every win back.
+void runShardTest(const std::vector<std::vector<std::vector<int>>> &grids) {
+  printHeader("TEST: Multi-Process Shards");
+
+  const std::string path = "shard_test.txt";
+  std::vector<std::string> puzzles;
+  {
+    std::ofstream out(path);
+    for (int i = 0; i < 40; ++i) {
+      SudokuBoard board;
+      board.loadBoard(grids[i % grids.size()]);
+      puzzles.push_back(board.toString());
+      out << puzzles.back() << "\n";
+    }
+  }
+  BatchSolver batch;
+  std::vector<BatchSolver::Result> expected = batch.solveAll(puzzles);
+
+  ShardCoordinator::Options options;
+  options.workers = 3;
+  options.shards = 8;
+  options.maxAttempts = 2;
+  ShardCoordinator coordinator(batch, options);
+  coordinator.setWorkerHook([](int shard, int attempt) {
+    if ((shard == 2 && attempt == 0) || shard == 5)
+      std::raise(SIGKILL);
+  });
+  std::vector<BatchSolver::Result> results;
+  bool ok = coordinator.solve(path, results);
+
+  // Portfolio wins come back from the workers and add up per config
+  BatchSolver portfolioBatch(BatchSolver::Engine::PORTFOLIO);
+  ShardCoordinator::Options portfolioOptions;
+  portfolioOptions.workers = 2;
+  portfolioOptions.shards = 4;
+  ShardCoordinator portfolioCoordinator(portfolioBatch, portfolioOptions);
+  std::vector<BatchSolver::Result> raced;
+  bool portfolioOk = portfolioCoordinator.solve(path, raced);
+  const BatchSolver::Stats &portfolioStats =
+      portfolioCoordinator.getStats().batch;
+  long long wins = 0;
+  for (long long w : portfolioStats.portfolioWins)
+    wins += w;
+  std::remove(path.c_str());
+  if (!portfolioOk || raced.size() != expected.size() ||
+      portfolioStats.portfolioWins.size() !=
+          portfolioBatch.getPortfolio().getConfigs().size() ||
+      wins != portfolioStats.solved || portfolioStats.solved != 40) {
+    std::cout << "[FAILURE] Portfolio wins lost across processes.\n";
+    exit(1);
+  }
+  std::cout << "Portfolio over processes: " << wins << " wins merged\n";
+
+  const ShardCoordinator::Stats &stats = coordinator.getStats();
+  long long lost = 0;
+  for (size_t i = 0; ok && i < results.size(); ++i) {
+    if (results[i].solution != expected[i].solution)
+      lost++;
+  }
+  std::cout << stats.shards << " shards, " << stats.requeued << " requeued, "
+            << stats.failedShards << " given up, " << lost
+            << " puzzles unsolved\n";
+  if (!ok || results.size() != expected.size() || stats.requeued != 2 ||
+      stats.failedShards != 1 || lost != 5 || stats.batch.failed != 5 ||
+      stats.batch.solved != 35) {
+    std::cout << "[FAILURE] Sharded results differ from the in-process run.\n";
+    exit(1);
+  }
+  std::vector<BatchSolver::Result> none;
+  if (coordinator.solve("no_such_shard_file.txt", none) ||
+      coordinator.getError().empty()) {
+    std::cout << "[FAILURE] A missing file was not reported.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Dead worker retried, results merged in order.\n";
+}
+
+// Givens must land exactly on a rotationally symmetric mask.
+void runPatternTest() {
+  printHeader("TEST: Pattern Generation");
+
+  std::bitset<81> mask;
+  Generator::parsePattern("x.x...x.x .x.x.x.x. x...x...x"
+                          " .x.....x. ..x.x.x.. .x.....x."
+                          " x...x...x .x.x.x.x. x.x...x.x",
+                          mask);
+  Generator::PatternOptions options;
+  options.seed = 7;
+  options.threads = 2;
+  options.maxAttempts = 50;
+
+  SudokuBoard board;
+  Generator generator;
+  Generator::PatternResult result =
+      generator.generateWithPattern(board, mask, options);
+
+  bool onMask = result.found;
+  for (int cell = 0; onMask && cell < 81; ++cell) {
+    bool given = board.isFixed(cell / 9, cell % 9);
+    onMask = given == mask[cell] && given == mask[80 - cell];
+  }
+  std::cout << mask.count() << " clues after " << result.attempts
+            << " attempt(s), " << result.seconds << "s\n";
+  if (!onMask || Solver(board).countSolutions(2) != 1) {
+    std::cout << "[FAILURE] Puzzle is not unique or misses the pattern.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Unique puzzle on the pattern.\n";
+}
+
+// Plays a right and a wrong digit on a unique puzzle, then a digit that only
+// disagrees with the stored solution of an open one.
+void runHintTest(const std::vector<std::vector<int>> &uniqueGrid,
+                 const std::vector<std::vector<int>> &openGrid) {
+  printHeader("TEST: Hints and Move Checking");
+
+  SudokuBoard board;
+  board.loadBoard(uniqueGrid);
+  SudokuBoard solved = board;
+  Solver(solved).solve();
+
+  HintEngine hints;
+  hints.load(board);
+  hints.wait();
+
+  auto start = std::chrono::steady_clock::now();
+  HintEngine::Hint hint = hints.nextHint();
+  double hintMs = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  bool ok = hint.found && hint.value == solved.getValue(hint.row, hint.col);
+  std::cout << hint.text << " (" << hintMs << " ms)\n";
+
+  // A locally valid digit that is not the solution's
+  int wrongCell = -1, wrongValue = 0;
+  for (int cell = 0; cell < 81 && wrongCell < 0; ++cell) {
+    int r = cell / 9, c = cell % 9;
+    for (int n = 1; n <= 9 && board.getValue(r, c) == 0; ++n) {
+      if (n != solved.getValue(r, c) && board.isValid(r, c, n)) {
+        wrongCell = cell;
+        wrongValue = n;
+        break;
+      }
+    }
+  }
+  int r = wrongCell / 9, c = wrongCell % 9;
+  ok = ok && hints.place(r, c, solved.getValue(r, c)) ==
+                 HintEngine::Verdict::SOLVABLE;
+  ok = ok && hints.place(r, c, wrongValue) == HintEngine::Verdict::WRONG;
+  hint = hints.nextHint();
+  ok = ok && hint.row == r && hint.col == c;
+  hints.clear(r, c);
+  ok = ok && hints.getVerdict() == HintEngine::Verdict::SOLVABLE;
+
+  // Open puzzle: a mismatch is re-checked in the background
+  board.loadBoard(openGrid);
+  hints.load(board);
+  hints.wait();
+  SudokuBoard probe = board;
+  Solver(probe).solve();
+  for (int n = 1; n <= 9; ++n) {
+    if (n != probe.getValue(0, 0) && board.isValid(0, 0, n)) {
+      board.placeNumber(0, 0, n);
+      if (Solver(board).countSolutions(1) == 1) {
+        hints.place(0, 0, n);
+        hints.wait();
+        ok = ok && hints.getVerdict() == HintEngine::Verdict::SOLVABLE;
+        break;
+      }
+      board.removeNumber(0, 0);
+    }
+  }
+
+  if (!ok) {
+    std::cout << "[FAILURE] Wrong verdict or hint.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Verdicts and hints are consistent.\n";
+}
+
+// The estimate must rank the hard grid above the easy one without touching
+// the board, and the scheduled batch must route the hard grid as predicted.
+void runEstimateTest(const std::vector<std::vector<int>> &easyGrid,
+                     const std::vector<std::vector<int>> &hardGrid) {
+  printHeader("TEST: Search Tree Estimate");
+
+  SudokuBoard easy, hard;
+  easy.loadBoard(easyGrid);
+  hard.loadBoard(hardGrid);
+  SudokuBoard before = hard;
+  Solver::TreeEstimate easyEst = Solver(easy).estimateSearch();
+  Solver::TreeEstimate hardEst = Solver(hard).estimateSearch();
+  std::cout << "Easy: " << easyEst.nodes << " nodes ("
+            << easyEst.logicPlacements << " by logic), hard: " << hardEst.nodes
+            << " nodes, "
+            << hardEst.seconds << "s predicted\n";
+
+  BatchSolver batch(BatchSolver::Engine::SCHEDULED);
+  batch.setThreads(2);
+  batch.setPortfolioThreshold(hardEst.nodes);
+  std::vector<BatchSolver::Result> results =
+      batch.solveAll({easy.toString(), hard.toString()});
+
+  if (!(hardEst.nodes > easyEst.nodes) || hard != before ||
+      batch.getStats().solved != 2 ||
+      batch.getStats().routedToPortfolio != 1) {
+    std::cout << "[FAILURE] Estimate or schedule is off.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Hard grid predicted costlier and routed.\n";
+}
+
+// The built-in table sends puzzles to different engines: the easy grid
+// needs no search, the hard grid (no probe finds its single solution, like
+// an unsolvable grid) goes to SAT and a sparse 19-clue grid with many
+// solutions and a 10^6-node tree to RESTARTS. A custom table that makes the
+// portfolio cheapest for the hard grid's bucket must pick it, survive a
+// save/load round trip, and the adaptive batch must solve all three grids
+// and count the portfolio win.
+void runSelectorTest(const std::vector<std::vector<int>> &easyGrid,
+                     const std::vector<std::vector<int>> &hardGrid) {
+  printHeader("TEST: Adaptive Engine Selection");
+
+  SudokuBoard easy, hard, sparse;
+  easy.loadBoard(easyGrid);
+  hard.loadBoard(hardGrid);
+  sparse.loadFromString("000580612506900000000000000"
+                        "800100000000000000060005003"
+                        "670000000080006700001000000");
+  const std::vector<std::string> puzzles = {easy.toString(), hard.toString(),
+                                            sparse.toString()};
+  EngineSelector::Features easyF = EngineSelector::extract(easy);
+  EngineSelector::Features hardF = EngineSelector::extract(hard);
+  EngineSelector::Features sparseF = EngineSelector::extract(sparse);
+  EngineSelector builtIn;
+  using Engine = EngineSelector::Engine;
+  std::cout << "Hard: " << hardF.emptyAfterLogic << " empty after singles, "
+            << hardF.treeNodes << " tree nodes -> "
+            << EngineSelector::engineName(builtIn.choose(hardF)) << "\n";
+  std::cout << "Sparse: " << sparseF.emptyAfterLogic
+            << " empty after singles, " << sparseF.treeNodes
+            << " tree nodes -> "
+            << EngineSelector::engineName(builtIn.choose(sparseF)) << "\n";
+
+  BatchSolver builtInBatch(BatchSolver::Engine::ADAPTIVE);
+  builtInBatch.solveAll(puzzles);
+  const BatchSolver::Stats &builtInStats = builtInBatch.getStats();
+
+  EngineSelector custom;
+  custom.clear();
+  custom.record(hardF, Engine::SAT, 0.002);
+  custom.record(hardF, Engine::PORTFOLIO, 0.001);
+  const std::string path = "selector_test.txt";
+  EngineSelector reloaded;
+  bool roundTrip = custom.save(path) && reloaded.load(path);
+  std::remove(path.c_str());
+
+  BatchSolver batch(BatchSolver::Engine::ADAPTIVE);
+  batch.setSelector(reloaded);
+  batch.solveAll(puzzles);
+  const BatchSolver::Stats &stats = batch.getStats();
+
+  if (builtIn.choose(easyF) != Engine::LOGIC ||
+      builtIn.choose(hardF) != Engine::SAT ||
+      builtIn.choose(sparseF) != Engine::RESTARTS ||
+      builtInStats.solved != 3 ||
+      builtInStats.enginePicks[static_cast<int>(Engine::RESTARTS)] != 1 ||
+      !roundTrip || reloaded.choose(hardF) != Engine::PORTFOLIO ||
+      stats.solved != 3 ||
+      stats.enginePicks[static_cast<int>(Engine::PORTFOLIO)] != 1 ||
+      std::accumulate(stats.portfolioWins.begin(), stats.portfolioWins.end(),
+                      0LL) != 1) {
+    std::cout << "[FAILURE] Selection does not follow the features/table.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Cheapest calibrated engine picked per puzzle.\n";
+}
+
+// All four default engines race the hard grid: live counters never go
+// backwards, everyone finishes with the same solution in a distinct place,
+// and a second race can be cancelled at once.
+void runRaceTest(const std::vector<std::vector<int>> &hardGrid) {
+  printHeader("TEST: Engine Race");
+
+  SudokuBoard puzzle;
+  puzzle.loadBoard(hardGrid);
+  EngineRace race;
+  race.start(puzzle);
+  std::vector<long long> seen(race.size(), 0);
+  bool monotonic = true;
+  while (race.isRunning()) {
+    for (size_t i = 0; i < race.size(); ++i) {
+      EngineRace::Status s = race.getStatus(i);
+      monotonic = monotonic && (s.finished || s.nodes >= seen[i]);
+      seen[i] = s.nodes;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  race.wait();
+
+  std::set<int> places;
+  bool sameSolution = true;
+  for (size_t i = 0; i < race.size(); ++i) {
+    EngineRace::Status s = race.getStatus(i);
+    std::cout << race.getLane(i).name << ": place " << s.place << ", "
+              << s.nodes << " nodes, " << s.seconds * 1000 << " ms\n";
+    if (s.solved)
+      places.insert(s.place);
+    sameSolution = sameSolution && race.getBoard(i).isComplete() &&
+                   race.getBoard(i) == race.getBoard(0);
+  }
+
+  race.start(puzzle);
+  race.cancel();
+
+  if (!monotonic || places.size() != race.size() || *places.begin() != 1 ||
+      !sameSolution || race.isRunning()) {
+    std::cout << "[FAILURE] Race results are inconsistent.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Every engine solved it; places are distinct.\n";
+}
+
+// A short mining run must give the same archive with one or two threads,
+// keep it sorted and unique-solution, and reload it from disk.
+void runMinerTest() {
+  printHeader("TEST: Hardest-Puzzle Miner");
+
+  PuzzleMiner::Options options;
+  options.archiveSize = 6;
+  options.children = 16;
+  options.generations = 4;
+  options.seed = 7;
+  options.threads = 2;
+  options.archivePath = "miner_test.txt";
+  PuzzleMiner miner(options);
+  std::vector<PuzzleMiner::Elite> archive = miner.run();
+
+  options.threads = 1;
+  options.archivePath.clear();
+  PuzzleMiner serial(options);
+  serial.run();
+
+  PuzzleMiner reloaded(options);
+  bool loaded = reloaded.load("miner_test.txt");
+  std::remove("miner_test.txt");
+
+  bool ok = !archive.empty() && loaded &&
+            reloaded.getArchive().size() == archive.size() &&
+            serial.getArchive().size() == archive.size();
+  for (size_t i = 0; ok && i < archive.size(); ++i) {
+    PuzzleMiner::Elite check;
+    ok = serial.getArchive()[i].puzzle == archive[i].puzzle &&
+         reloaded.getArchive()[i].puzzle == archive[i].puzzle &&
+         (i == 0 || archive[i - 1].fitness >= archive[i].fitness) &&
+         PuzzleMiner::evaluate(archive[i].puzzle, options.objective, nullptr,
+                               check) &&
+         check.fitness == archive[i].fitness;
+  }
+  if (!archive.empty())
+    std::cout << "Hardest: " << archive[0].puzzle << " ("
+              << archive[0].backtracks << " backtracks)\n";
+  if (!ok) {
+    std::cout << "[FAILURE] Miner archive is inconsistent.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Archive reproducible, unique and reloadable.\n";
+}
+
+// Counters around a hard solve: whatever the kernel grants must count up,
+// and what it refuses must read as invalid rather than as zero.
+void runPerfTest(const std::vector<std::vector<int>> &hardGrid) {
+  printHeader("TEST: Performance Counters");
+
+  PerfCounters counters;
+  SudokuBoard board;
+  board.loadBoard(hardGrid);
+  PerfCounters::Sample before = counters.read();
+  Solver solver(board);
+  bool solved = solver.solve();
+  PerfCounters::Sample d = PerfCounters::delta(before, counters.read());
+
+  bool ok = solved && d.seconds > 0.0;
+  for (int e = 0; e < PerfCounters::kEventCount; ++e) {
+    PerfCounters::Event event = static_cast<PerfCounters::Event>(e);
+    if (!counters.available(event)) {
+      ok = ok && !d.valid[e];
+      continue;
+    }
+    std::cout << PerfCounters::eventName(event) << ": " << d.values[e]
+              << "\n";
+    ok = ok && (!d.valid[e] || d.values[e] >= 0.0);
+  }
+  if (counters.available(PerfCounters::TASK_CLOCK))
+    ok = ok && d.valid[PerfCounters::TASK_CLOCK] &&
+         d.values[PerfCounters::TASK_CLOCK] > 0.0;
+  if (!counters.getError().empty())
+    std::cout << "Unavailable: " << counters.getError() << "\n";
+
+  if (!ok) {
+    std::cout << "[FAILURE] Counter readings are inconsistent.\n";
+    exit(1);
+  }
+  std::cout << "[SUCCESS] Counters read, missing ones reported.\n";
+}
+
 int main(int argc, char *argv[]) {
   std::string mode = (argc > 1) ? argv[1] : "all";
+  // Optional: SolverTest hard trace.bin  (then inspect with SolverTraceTool)
+  std::string tracePath = (argc > 2) ? argv[2] : "";
+  // With "all", each traced test gets its own file: trace_easy.bin, ...
+  auto traceFor = [&](const std::string &test) {
+    if (tracePath.empty() || mode != "all")
+      return tracePath;
+    size_t dot = tracePath.find_last_of('.');
+    size_t slash = tracePath.find_last_of('/');
+    if (dot == std::string::npos ||
+        (slash != std::string::npos && dot < slash))
+      dot = tracePath.size();
+    return tracePath.substr(0, dot) + "_" + test + tracePath.substr(dot);
+  };
 
   // 1. Easy Puzzle (Solvable by Logic)
   // From a known easy source
@@ -74,10 +1454,94 @@ int main(int argc, char *argv[]) {
       {0, 0, 0, 0, 0, 0, 0, 4, 0}};
 
   if (mode == "easy" || mode == "all") {
-    runTest("Easy (Logic Check)", easyGrid, Solver::Mode::HYBRID);
+    runTest("Easy (Logic Check)", easyGrid, Solver::Mode::HYBRID,
+            traceFor("easy"));
   }
   if (mode == "hard" || mode == "all") {
-    runTest("Hard (Backtrack Check)", hardGrid, Solver::Mode::HYBRID);
+    runTest("Hard (Backtrack Check)", hardGrid, Solver::Mode::HYBRID,
+            traceFor("hard"));
+  }
+  if (mode == "trace" || mode == "all") {
+    runTraceTest(hardGrid);
+  }
+  if (mode == "restarts" || mode == "all") {
+    runTest("Hard (Random Restarts)", hardGrid, Solver::Mode::RANDOM_RESTARTS);
+    runRestartScheduleTest(hardGrid);
+  }
+  if (mode == "sat" || mode == "all") {
+    runTest("Hard (SAT)", hardGrid, Solver::Mode::SAT);
+    runLargeSatTest(4);
+    runLargeSatTest(5);
+  }
+  if (mode == "portfolio" || mode == "all") {
+    runPortfolioTest(hardGrid);
+  }
+  if (mode == "variants" || mode == "all") {
+    runVariantTests(easyGrid, hardGrid);
+  }
+  if (mode == "board" || mode == "all") {
+    runBoardCopyTest(easyGrid);
+  }
+  // Drop the top three rows of the easy grid to open up many solutions.
+  std::vector<std::vector<int>> openGrid = easyGrid;
+  openGrid[0].assign(9, 0);
+  openGrid[1].assign(9, 0);
+  openGrid[2].assign(9, 0);
+
+  if (mode == "constexpr" || mode == "all") {
+    runConstexprTest(easyGrid, openGrid);
+  }
+  if (mode == "count" || mode == "all") {
+    runCountTest("Hard", hardGrid, 1);
+    runCountTest("Underconstrained", openGrid, -1);
+  }
+  if (mode == "enumerate" || mode == "all") {
+    runEnumerateTest(openGrid);
+  }
+  if (mode == "resume" || mode == "all") {
+    runResumeTest(openGrid);
+  }
+  if (mode == "hints" || mode == "all") {
+    runHintTest(hardGrid, openGrid);
+  }
+  if (mode == "minimal" || mode == "all") {
+    runMinimalTest();
+  }
+  if (mode == "heatmap" || mode == "all") {
+    runHeatmapTest(hardGrid);
+  }
+  if (mode == "verify" || mode == "all") {
+    runVerifierTest();
+  }
+  if (mode == "pool" || mode == "all") {
+    runPoolTest();
+  }
+  if (mode == "sampler" || mode == "all") {
+    runSamplerTest();
+  }
+  if (mode == "pattern" || mode == "all") {
+    runPatternTest();
+  }
+  if (mode == "estimate" || mode == "all") {
+    runEstimateTest(easyGrid, hardGrid);
+  }
+  if (mode == "race" || mode == "all") {
+    runRaceTest(hardGrid);
+  }
+  if (mode == "miner" || mode == "all") {
+    runMinerTest();
+  }
+  if (mode == "perf" || mode == "all") {
+    runPerfTest(hardGrid);
+  }
+  if (mode == "selector" || mode == "all") {
+    runSelectorTest(easyGrid, hardGrid);
+  }
+  if (mode == "shards" || mode == "all") {
+    runShardTest({easyGrid, hardGrid});
+  }
+  if (mode == "batch" || mode == "all") {
+    runBatchTest({easyGrid, hardGrid});
   }
 
   return 0;
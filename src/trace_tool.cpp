@@ -0,0 +1,209 @@
+#include "SolveTrace.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Offline analyzer for binary solve traces written by TraceWriter.
+// Everything is computed in a single streaming pass with fixed-size
+// accumulators, so trace size is only bounded by disk.
+
+namespace {
+
+struct TechniqueRun {
+  TraceTechnique technique;
+  uint64_t length;
+};
+
+void printUsage(const char *prog) {
+  std::cout << "Usage: " << prog << " <trace.bin> [--top N] [--runs N]\n"
+            << "  --top N   Backtrack hot cells to list (default 10)\n"
+            << "  --runs N  Number of technique runs to print (default 40)\n";
+}
+
+int log2Bucket(uint64_t ns) {
+  int b = 0;
+  while (ns > 1 && b < 63) {
+    ns >>= 1;
+    b++;
+  }
+  return b;
+}
+
+std::string formatNs(double ns) {
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(2);
+  if (ns >= 1e9)
+    ss << ns / 1e9 << " s";
+  else if (ns >= 1e6)
+    ss << ns / 1e6 << " ms";
+  else if (ns >= 1e3)
+    ss << ns / 1e3 << " us";
+  else
+    ss << ns << " ns";
+  return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  std::string path = argv[1];
+  size_t topCells = 10;
+  size_t maxRuns = 40;
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string opt = argv[i];
+    if (opt == "--top")
+      topCells = static_cast<size_t>(std::atoi(argv[i + 1]));
+    else if (opt == "--runs")
+      maxRuns = static_cast<size_t>(std::atoi(argv[i + 1]));
+  }
+
+  TraceReader reader;
+  if (!reader.open(path)) {
+    std::cerr << "Error: " << path << " is not a readable solve trace.\n";
+    return 1;
+  }
+
+  uint64_t total = 0;
+  uint64_t eventCounts[3] = {0, 0, 0};
+  uint64_t techniqueCounts[8] = {0};
+  std::vector<uint64_t> nodesPerDepth;
+  uint64_t backtracksPerCell[81] = {0};
+  uint64_t placementsPerCell[81] = {0};
+  uint64_t timeBuckets[64] = {0};
+  uint64_t totalNs = 0;
+  uint64_t maxGapNs = 0;
+  int maxDepth = 0;
+
+  // Technique sequence is run-length encoded; only the head is kept.
+  std::vector<TechniqueRun> runs;
+  uint64_t runCount = 0;
+  TechniqueRun current{TraceTechnique::NONE, 0};
+
+  TraceRecord rec;
+  while (reader.next(rec)) {
+    total++;
+    if (static_cast<int>(rec.event) < 3)
+      eventCounts[static_cast<int>(rec.event)]++;
+    techniqueCounts[static_cast<int>(rec.technique) & 0x7]++;
+    totalNs += rec.deltaNs;
+    maxGapNs = std::max(maxGapNs, rec.deltaNs);
+    timeBuckets[log2Bucket(rec.deltaNs)]++;
+    maxDepth = std::max(maxDepth, rec.depth);
+
+    if (rec.cell >= 0 && rec.cell < 81) {
+      if (rec.event == TraceEvent::REMOVE)
+        backtracksPerCell[rec.cell]++;
+      else
+        placementsPerCell[rec.cell]++;
+    }
+
+    if (rec.event == TraceEvent::PLACE && rec.depth >= 0) {
+      if (static_cast<size_t>(rec.depth) >= nodesPerDepth.size())
+        nodesPerDepth.resize(rec.depth + 1, 0);
+      nodesPerDepth[rec.depth]++;
+    }
+
+    // Removals are bookkeeping; the sequence only tracks deciding steps.
+    if (rec.event != TraceEvent::REMOVE) {
+      if (rec.technique == current.technique) {
+        current.length++;
+      } else {
+        if (current.length > 0) {
+          runCount++;
+          if (runs.size() < maxRuns)
+            runs.push_back(current);
+        }
+        current = {rec.technique, 1};
+      }
+    }
+  }
+  if (current.length > 0) {
+    runCount++;
+    if (runs.size() < maxRuns)
+      runs.push_back(current);
+  }
+
+  std::cout << "========================================\n";
+  std::cout << "  TRACE SUMMARY: " << path << "\n";
+  std::cout << "========================================\n";
+
+  std::cout << "Initial Board:\n";
+  const uint8_t *grid = reader.getInitialGrid();
+  for (int r = 0; r < 9; ++r) {
+    std::cout << "  ";
+    for (int c = 0; c < 9; ++c) {
+      int v = grid[r * 9 + c];
+      std::cout << (v == 0 ? '.' : static_cast<char>('0' + v));
+    }
+    std::cout << "\n";
+  }
+
+  std::cout << "\nEvents      : " << total << "\n";
+  std::cout << "  Placements: " << eventCounts[0] << "\n";
+  std::cout << "  Removals  : " << eventCounts[1] << "\n";
+  std::cout << "  Logic     : " << eventCounts[2] << "\n";
+  std::cout << "Max Depth   : " << maxDepth << "\n";
+  std::cout << "Trace Time  : " << formatNs(static_cast<double>(totalNs))
+            << "\n";
+
+  std::cout << "\n--- NODES PER DEPTH ---\n";
+  for (size_t d = 0; d < nodesPerDepth.size(); ++d) {
+    if (nodesPerDepth[d] > 0)
+      std::cout << "  depth " << std::setw(2) << d << " : " << nodesPerDepth[d]
+                << "\n";
+  }
+
+  std::cout << "\n--- BACKTRACK HOT CELLS ---\n";
+  std::vector<int> cells(81);
+  for (int i = 0; i < 81; ++i)
+    cells[i] = i;
+  std::sort(cells.begin(), cells.end(), [&](int a, int b) {
+    return backtracksPerCell[a] > backtracksPerCell[b];
+  });
+  for (size_t i = 0; i < std::min<size_t>(topCells, cells.size()); ++i) {
+    int cell = cells[i];
+    if (backtracksPerCell[cell] == 0)
+      break;
+    std::cout << "  (" << cell / 9 << "," << cell % 9
+              << ") backtracks: " << backtracksPerCell[cell]
+              << "  placements: " << placementsPerCell[cell] << "\n";
+  }
+
+  std::cout << "\n--- TIME BETWEEN EVENTS ---\n";
+  if (total > 0) {
+    std::cout << "  mean: " << formatNs(static_cast<double>(totalNs) / total)
+              << "  max: " << formatNs(static_cast<double>(maxGapNs)) << "\n";
+    for (int b = 0; b < 64; ++b) {
+      if (timeBuckets[b] > 0)
+        std::cout << "  < " << std::setw(10)
+                  << formatNs(static_cast<double>(2ULL << b)) << " : "
+                  << timeBuckets[b] << "\n";
+    }
+  }
+
+  std::cout << "\n--- TECHNIQUES ---\n";
+  for (int t = 1; t < 8; ++t) {
+    if (techniqueCounts[t] > 0)
+      std::cout << "  " << techniqueToString(static_cast<TraceTechnique>(t))
+                << " : " << techniqueCounts[t] << "\n";
+  }
+
+  std::cout << "\n--- TECHNIQUE SEQUENCE (" << runCount << " runs) ---\n";
+  for (const TechniqueRun &run : runs) {
+    std::cout << "  " << techniqueToString(run.technique) << " x"
+              << run.length << "\n";
+  }
+  if (runCount > runs.size())
+    std::cout << "  ... " << (runCount - runs.size()) << " more runs\n";
+
+  return 0;
+}